@@ -0,0 +1,83 @@
+//
+// Numeric field conversion against the C library and std::istream.
+//
+
+#include "csv.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+
+template<typename Function>
+void run(const char* name, const std::vector<std::string>& fields, size_t bytes, Function&& function)
+{
+    decltype(function(fields.front())) sum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& field : fields)
+    {
+        sum += function(field);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("%-24s %8.1f MB/s %8.1f ns/field (checksum %g)\n", name, static_cast<double>(bytes) / 1e6 / elapsed.count(),
+                elapsed.count() * 1e9 / static_cast<double>(fields.size()), static_cast<double>(sum));
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t nFields = argc > 1 ? std::stoul(argv[1]) : 5'000'000;
+
+    // Sensor-style values such as data/test_float.csv, plus full-precision doubles
+    std::mt19937_64 random(2021);
+    std::uniform_real_distribution<double> distribution(-1e4, 1e4);
+    std::vector<std::string> fields(nFields);
+    size_t bytes = 0;
+    char text[64];
+    for (auto& field : fields)
+    {
+        std::snprintf(text, sizeof(text), "%.*g", static_cast<int>(3 + random() % 15), distribution(random));
+        field = text;
+        bytes += field.size() + 1;
+    }
+
+    run("csv::detail (double)", fields, bytes, [](const std::string& field)
+    {
+        double value;
+        csv::detail::parse_value(field, value);
+        return value;
+    });
+    run("strtod", fields, bytes, [](const std::string& field) { return std::strtod(field.c_str(), nullptr); });
+    run("std::istringstream", fields, bytes, [](const std::string& field)
+    {
+        double value = 0;
+        std::istringstream(field) >> value;
+        return value;
+    });
+
+    // 8-16 digit identifiers and timestamps
+    std::uniform_int_distribution<long> integers(10'000'000, 9'999'999'999'999'999);
+    bytes = 0;
+    for (auto& field : fields)
+    {
+        field = std::to_string(integers(random) >> (random() % 28));
+        bytes += field.size() + 1;
+    }
+
+    run("csv::detail (long)", fields, bytes, [](const std::string& field)
+    {
+        long value;
+        csv::detail::parse_value(field, value);
+        return value;
+    });
+    run("strtol", fields, bytes, [](const std::string& field) { return std::strtol(field.c_str(), nullptr, 10); });
+    run("std::istringstream", fields, bytes, [](const std::string& field)
+    {
+        long value = 0;
+        std::istringstream(field) >> value;
+        return value;
+    });
+}
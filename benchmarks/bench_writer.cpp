@@ -0,0 +1,65 @@
+//
+// Writer throughput against a hand-rolled std::ofstream loop.
+//
+
+#include "csv.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+#include <random>
+
+namespace
+{
+
+using Rows = std::vector<std::array<double, 8>>;
+
+template<typename Function>
+void run(const char* name, const std::filesystem::path& path, Function&& function)
+{
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const auto bytes = static_cast<double>(std::filesystem::file_size(path));
+    std::printf("%-28s %9.1f MB %9.1f MB/s %8.3f s\n", name, bytes / 1e6, bytes / 1e6 / elapsed.count(), elapsed.count());
+}
+
+void write_ostream(const std::filesystem::path& path, const Rows& rows, int precision)
+{
+    std::ofstream file(path);
+    file << std::setprecision(precision);
+    for (const auto& row : rows)
+    {
+        for (size_t i = 0; i < row.size(); ++i)
+        {
+            file << row[i] << (i + 1 < row.size() ? ',' : '\n');
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t nRows = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+    const auto path = std::filesystem::temp_directory_path() / "std_csv_bench_writer.csv";
+
+    std::mt19937_64 random(2020);
+    std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+    Rows rows(nRows);
+    for (auto& row : rows)
+    {
+        for (auto& value : row)
+        {
+            value = distribution(random);
+        }
+    }
+
+    run("ostream (precision 6, lossy)", path, [&] { write_ostream(path, rows, 6); });
+    run("ostream (precision 17)", path, [&] { write_ostream(path, rows, 17); });
+    run("csv::write", path, [&] { csv::write(path.string(), rows); });
+    run("csv::write (all threads)", path, [&] { csv::write(path.string(), rows, {',', csv::quoting::minimal, 0}); });
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,278 @@
+//
+// Reader throughput on synthetic datasets.
+//
+// Usage: benchmarks [--sizes small,medium,large] [--repetitions N] [--filter TEXT] [--json PATH]
+//
+
+#include "csv.hpp"
+#include "datasets.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace
+{
+
+struct Dataset
+{
+    const char* name;
+    std::function<std::string(size_t)> generate;
+    std::vector<std::pair<const char*, std::function<size_t(const std::string&)>>> readers;
+};
+
+struct Result
+{
+    std::string dataset;
+    std::string size;
+    std::string function;
+    size_t bytes;
+    size_t rows;
+    double seconds;
+    size_t peakRss;
+};
+
+template<typename Function>
+std::pair<const char*, std::function<size_t(const std::string&)>> reader(const char* name, Function function)
+{
+    return {name, [function](const std::string& path) { return static_cast<size_t>(function(path).size()); }};
+}
+
+std::pair<const char*, std::function<size_t(const std::string&)>> header_reader()
+{
+    return {"get_header", [](const std::string& path) { return static_cast<size_t>(!csv::get_header(path).empty()); }};
+}
+
+std::vector<Dataset> make_datasets()
+{
+    const auto numericReaders = [] {
+        return std::vector{
+                header_reader(),
+                reader("to_vectors<double>", [](const std::string& path) { return csv::to_vectors<double>(path); }),
+                reader("to_arrays<double, 8>", [](const std::string& path) { return csv::to_arrays<double, 8>(path); }),
+                reader("to_tuples<long, long, double x5, int>", [](const std::string& path)
+                {
+                    return csv::to_tuples<long, long, double, double, double, double, double, int>(path);
+                }),
+        };
+    };
+    return {
+            {"numeric", [](size_t n) { return datasets::numeric(n); }, numericReaders()},
+            {"crlf", datasets::crlf, numericReaders()},
+            {"strings", datasets::strings, {
+                    header_reader(),
+                    reader("to_vectors<string>", [](const std::string& path)
+                    {
+                        return csv::to_vectors<std::string>(path);
+                    }),
+                    reader("to_arrays<string, 6>", [](const std::string& path)
+                    {
+                        return csv::to_arrays<std::string, 6>(path);
+                    }),
+                    reader("to_tuples<string, ignore, string, ignore x2, string>", [](const std::string& path)
+                    {
+                        using csv::ignore;
+                        return csv::to_tuples<std::string, ignore, std::string, ignore, ignore, std::string>(path);
+                    }),
+            }},
+            {"wide", datasets::wide, {
+                    header_reader(),
+                    reader("to_vectors<int>", [](const std::string& path) { return csv::to_vectors<int>(path); }),
+                    reader("to_arrays<int, 64>", [](const std::string& path) { return csv::to_arrays<int, 64>(path); }),
+                    reader("to_tuples<int x4>", [](const std::string& path)
+                    {
+                        return csv::to_tuples<int, int, int, int>(path);
+                    }),
+            }},
+            {"quoted", datasets::quoted, {
+                    header_reader(),
+                    reader("to_vectors<string>", [](const std::string& path)
+                    {
+                        return csv::to_vectors<std::string>(path);
+                    }),
+                    reader("to_arrays<string, 5>", [](const std::string& path)
+                    {
+                        return csv::to_arrays<std::string, 5>(path);
+                    }),
+                    reader("to_tuples<long, string, string, double, string>", [](const std::string& path)
+                    {
+                        return csv::to_tuples<long, std::string, std::string, double, std::string>(path);
+                    }),
+            }},
+            {"ragged", datasets::ragged, {
+                    header_reader(),
+                    reader("to_vectors<long>", [](const std::string& path) { return csv::to_vectors<long>(path); }),
+                    reader("to_arrays<long, 12>", [](const std::string& path)
+                    {
+                        return csv::to_arrays<long, 12>(path);
+                    }),
+                    reader("to_tuples<long x3>", [](const std::string& path)
+                    {
+                        return csv::to_tuples<long, long, long>(path);
+                    }),
+            }},
+    };
+}
+
+/// @brief Starts a new peak resident set size measurement, where the platform allows it
+void reset_peak_rss()
+{
+#if defined(__GLIBC__)
+    malloc_trim(0); // return memory freed by the previous run so it does not count towards this one
+#endif
+#if defined(__linux__)
+    std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+/// @brief Peak resident set size in bytes since the last reset_peak_rss() (Linux) or since process start
+size_t peak_rss()
+{
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    for (std::string line; std::getline(status, line);)
+    {
+        if (line.rfind("VmHWM:", 0) == 0)
+        {
+            return std::stoul(line.substr(6)) * 1024;
+        }
+    }
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+    return 0;
+#endif
+}
+
+std::string json_escape(std::string_view text)
+{
+    std::string escaped;
+    for (const auto c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+void write_json(std::ostream& out, const std::vector<Result>& results, size_t repetitions)
+{
+    out << "{\n  \"repetitions\": " << repetitions << ",\n  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto& r = results[i];
+        char numbers[256];
+        std::snprintf(numbers, sizeof(numbers),
+                      "\"bytes\": %zu, \"rows\": %zu, \"seconds\": %.6f, \"mb_per_s\": %.2f, \"rows_per_s\": %.0f, "
+                      "\"peak_rss_bytes\": %zu",
+                      r.bytes, r.rows, r.seconds, static_cast<double>(r.bytes) / 1e6 / r.seconds,
+                      static_cast<double>(r.rows) / r.seconds, r.peakRss);
+        out << (i == 0 ? "\n" : ",\n") << "    {\"dataset\": \"" << json_escape(r.dataset) << "\", \"size\": \""
+            << json_escape(r.size) << "\", \"function\": \"" << json_escape(r.function) << "\", " << numbers << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+std::vector<std::string> split(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::istringstream stream(list);
+    for (std::string item; std::getline(stream, item, ',');)
+    {
+        items.push_back(item);
+    }
+    return items;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> sizes = {"small", "medium"};
+    size_t repetitions = 3;
+    std::string filter;
+    std::string jsonPath;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string_view option = argv[i];
+        if (option == "--sizes") sizes = split(argv[i + 1]);
+        else if (option == "--repetitions") repetitions = std::max<size_t>(1, std::stoul(argv[i + 1]));
+        else if (option == "--filter") filter = argv[i + 1];
+        else if (option == "--json") jsonPath = argv[i + 1];
+        else
+        {
+            std::cerr << "usage: " << argv[0]
+                      << " [--sizes small,medium,large] [--repetitions N] [--filter TEXT] [--json PATH]\n";
+            return 1;
+        }
+    }
+    const std::vector<std::pair<std::string, size_t>> rowsBySize = {
+            {"small", 10'000}, {"medium", 100'000}, {"large", 1'000'000}
+    };
+
+    const auto path = (std::filesystem::temp_directory_path() / "std_csv_benchmark.csv").string();
+    std::vector<Result> results;
+    for (const auto& dataset : make_datasets())
+    {
+        for (const auto& [size, nRows] : rowsBySize)
+        {
+            if (std::find(sizes.cbegin(), sizes.cend(), size) == sizes.cend())
+            {
+                continue;
+            }
+            {
+                const auto text = dataset.generate(nRows);
+                std::ofstream(path, std::ios::binary).write(text.data(), static_cast<std::streamsize>(text.size()));
+            }
+            const auto bytes = static_cast<size_t>(std::filesystem::file_size(path));
+            for (const auto& [function, read] : dataset.readers)
+            {
+                if ((std::string(dataset.name) + " " + function).find(filter) == std::string::npos)
+                {
+                    continue;
+                }
+                Result result{dataset.name, size, function, bytes, 0, std::numeric_limits<double>::max(), 0};
+                for (size_t repetition = 0; repetition < repetitions; ++repetition)
+                {
+                    reset_peak_rss();
+                    const auto start = std::chrono::steady_clock::now();
+                    result.rows = read(path);
+                    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                    result.seconds = std::min(result.seconds, elapsed.count());
+                    result.peakRss = std::max(result.peakRss, peak_rss());
+                }
+                std::printf("%-8s %-6s %-52s %9.1f MB/s %12.0f rows/s %8.1f MB peak\n", dataset.name, size.c_str(),
+                            function, static_cast<double>(bytes) / 1e6 / result.seconds,
+                            static_cast<double>(result.rows) / result.seconds,
+                            static_cast<double>(result.peakRss) / 1e6);
+                results.push_back(result);
+            }
+        }
+    }
+    std::filesystem::remove(path);
+
+    if (!jsonPath.empty())
+    {
+        std::ofstream json(jsonPath);
+        write_json(json, results, repetitions);
+    }
+}
@@ -0,0 +1,190 @@
+//
+// Deterministic synthetic CSV datasets for the benchmarks.
+//
+// Everything is derived from a fixed-seed splitmix64 stream with integer-only formatting, so a dataset is
+// byte-identical across platforms and standard libraries and results can be compared between releases.
+//
+
+#ifndef STDCSV_BENCHMARKS_DATASETS_HPP
+#define STDCSV_BENCHMARKS_DATASETS_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace datasets
+{
+
+class Random
+{
+public:
+    explicit Random(uint64_t seed) : state(seed) { }
+
+    uint64_t next()
+    {
+        auto z = (state += 0x9E3779B97F4A7C15);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+        return z ^ (z >> 31);
+    }
+
+    /// @brief Uniform in [0, bound)
+    uint64_t below(uint64_t bound) { return next() % bound; }
+
+private:
+    uint64_t state;
+};
+
+inline void append_int(std::string& out, int64_t value)
+{
+    out += std::to_string(value);
+}
+
+/// @brief A fixed-point decimal with the given number of fraction digits, e.g. -1234.5678
+inline void append_decimal(std::string& out, Random& random, int64_t integerBound, int fractionDigits)
+{
+    if (random.below(2))
+    {
+        out += '-';
+    }
+    append_int(out, static_cast<int64_t>(random.below(static_cast<uint64_t>(integerBound))));
+    out += '.';
+    for (int i = 0; i < fractionDigits; ++i)
+    {
+        out += static_cast<char>('0' + random.below(10));
+    }
+}
+
+inline void append_word(std::string& out, Random& random, size_t minLength, size_t maxLength)
+{
+    const auto length = minLength + random.below(maxLength - minLength + 1);
+    for (size_t i = 0; i < length; ++i)
+    {
+        out += static_cast<char>('a' + random.below(26));
+    }
+}
+
+inline void append_header(std::string& out, size_t nColumns, std::string_view lineEnding = "\n")
+{
+    for (size_t column = 0; column < nColumns; ++column)
+    {
+        out += column == 0 ? "" : ",";
+        out += "col" + std::to_string(column);
+    }
+    out += lineEnding;
+}
+
+/// @brief id, timestamp, five readings and a count: <long, long, double x5, int>
+inline std::string numeric(size_t nRows, std::string_view lineEnding = "\n")
+{
+    Random random(1);
+    std::string out;
+    append_header(out, 8, lineEnding);
+    for (size_t row = 0; row < nRows; ++row)
+    {
+        append_int(out, static_cast<int64_t>(row));
+        out += ',';
+        append_int(out, 1600000000000 + static_cast<int64_t>(row * 1000 + random.below(1000)));
+        for (int i = 0; i < 5; ++i)
+        {
+            out += ',';
+            append_decimal(out, random, 10000, 1 + static_cast<int>(random.below(8)));
+        }
+        out += ',';
+        append_int(out, static_cast<int64_t>(random.below(100000)));
+        out += lineEnding;
+    }
+    return out;
+}
+
+/// @brief The numeric dataset with Windows line endings
+inline std::string crlf(size_t nRows)
+{
+    return numeric(nRows, "\r\n");
+}
+
+/// @brief Six columns of lowercase words
+inline std::string strings(size_t nRows)
+{
+    Random random(2);
+    std::string out;
+    append_header(out, 6);
+    for (size_t row = 0; row < nRows; ++row)
+    {
+        for (int column = 0; column < 6; ++column)
+        {
+            out += column == 0 ? "" : ",";
+            append_word(out, random, 3, 16);
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+/// @brief 64 small integer columns
+inline std::string wide(size_t nRows)
+{
+    Random random(3);
+    std::string out;
+    append_header(out, 64);
+    for (size_t row = 0; row < nRows; ++row)
+    {
+        for (int column = 0; column < 64; ++column)
+        {
+            out += column == 0 ? "" : ",";
+            append_int(out, static_cast<int64_t>(random.below(1000)));
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+/// @brief id, quoted text with delimiters, quoted text with escaped quotes, a reading and a quoted field that
+/// sometimes spans two lines: <long, string, string, double, string>
+inline std::string quoted(size_t nRows)
+{
+    Random random(4);
+    std::string out;
+    append_header(out, 5);
+    for (size_t row = 0; row < nRows; ++row)
+    {
+        append_int(out, static_cast<int64_t>(row));
+        out += ",\"";
+        append_word(out, random, 2, 8);
+        out += ", ";
+        append_word(out, random, 2, 8);
+        out += "\",\"say \"\"";
+        append_word(out, random, 2, 8);
+        out += "\"\"\",";
+        append_decimal(out, random, 1000, 3);
+        out += ",\"";
+        append_word(out, random, 4, 12);
+        out += random.below(8) == 0 ? "\n" : " ";
+        append_word(out, random, 4, 12);
+        out += "\"\n";
+    }
+    return out;
+}
+
+/// @brief One to twelve integer columns per row
+inline std::string ragged(size_t nRows)
+{
+    Random random(5);
+    std::string out;
+    append_header(out, 12);
+    for (size_t row = 0; row < nRows; ++row)
+    {
+        const auto nColumns = 1 + random.below(12);
+        for (size_t column = 0; column < nColumns; ++column)
+        {
+            out += column == 0 ? "" : ",";
+            append_int(out, static_cast<int64_t>(random.below(1000000)));
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+} // namespace datasets
+
+#endif //STDCSV_BENCHMARKS_DATASETS_HPP
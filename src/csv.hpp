@@ -5,13 +5,60 @@
 #ifndef CSV_HPP
 #define CSV_HPP
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
 #include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <regex>
 #include <sstream>
+#include <thread>
 #include <tuple>
+#include <utility>
+#include <variant>
 #include <vector>
 
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sched.h>
+#include <sys/inotify.h>
+#endif
+
 namespace csv
 {
 
@@ -22,6 +69,100 @@ template<typename... Ts>
 using FilteredTuple = decltype(std::tuple_cat(
         std::declval<std::conditional_t<std::is_same<ignore, Ts>::value, std::tuple<>, std::tuple<Ts>>>()...));
 
+/// @brief Where the time and memory of a load went, filled in when passed to one of the to_* functions
+struct parse_stats
+{
+    size_t bytesRead = 0;
+    size_t rows = 0;
+    size_t fields = 0;
+    std::chrono::nanoseconds ioTime{};       ///< reading from the file
+    std::chrono::nanoseconds sniffTime{};    ///< detecting the delimiter
+    std::chrono::nanoseconds tokenizeTime{}; ///< finding records and fields
+    std::chrono::nanoseconds convertTime{};  ///< converting fields to values
+    std::chrono::nanoseconds growthTime{};   ///< appending values and rows to their containers
+    size_t allocations = 0;                  ///< container reallocations and strings too long for in-place storage
+    std::vector<size_t> conversionFailures;  ///< per column, fields that were not a valid value
+};
+
+/// @brief How far a load has got, as passed to read_options::onProgress
+struct load_progress
+{
+    uint64_t bytes = 0;      ///< of the file consumed
+    uint64_t totalBytes = 0; ///< size of the file, 0 if unknown
+    size_t rows = 0;         ///< stored so far
+    std::chrono::nanoseconds elapsed{};
+
+    /// @brief Bytes consumed per second so far
+    double throughput() const
+    {
+        return elapsed.count() > 0 ? static_cast<double>(bytes) * 1e9 / static_cast<double>(elapsed.count()) : 0;
+    }
+};
+
+/// @brief How the to_* functions read a file; a delimiter converts to the default options with that delimiter
+struct read_options
+{
+    read_options(char delimiter = '\0') : delimiter(delimiter) { }
+
+    char delimiter = '\0';     ///< '\0' detects the delimiter from the first record
+    char quote = '"';          ///< encloses fields with delimiters, line breaks or quotes, which are doubled
+    char lineBreak = '\n';     ///< ends a record; with '\n', a '\r' before it is dropped too
+    size_t skipRows = 0;       ///< lines passed over at the start of the file, before the header
+    size_t maxRows = std::numeric_limits<size_t>::max(); ///< data rows read at most
+    size_t expectedRows = 0;   ///< data rows to make room for up front, such as from count_rows(); 0 to grow as read
+    std::string commentPrefix; ///< lines starting with this are passed over wherever they appear, if not empty
+
+    /// @brief Keeps only rows whose field in column satisfies predicate; it gets the field unquoted, before any
+    /// other field of the row is converted
+    read_options& where(size_t column, std::function<bool(std::string_view)> predicate)
+    {
+        filterColumn = column;
+        filter = std::move(predicate);
+        filterValue.clear();
+        return *this;
+    }
+
+    /// @brief Keeps only rows whose field in column converts to a T that satisfies predicate
+    template<typename T, typename Predicate>
+    read_options& where(size_t column, Predicate predicate);
+
+    /// @brief Keeps only rows whose field in column is value
+    /// Records that do not contain value anywhere are rejected by a substring search over the whole block read,
+    /// without splitting them into fields.
+    read_options& where_equal(size_t column, std::string value)
+    {
+        where(column, [value](std::string_view field) { return field == value; });
+        filterValue = std::move(value);
+        return *this;
+    }
+
+    size_t filterColumn = 0;
+    std::function<bool(std::string_view)> filter; ///< rows are kept if empty
+    std::string filterValue;                      ///< set by where_equal
+
+    std::function<void(const load_progress&)> onProgress; ///< called after each block read, and once at the end
+    const std::atomic<bool>* cancel = nullptr; ///< once set, loading stops at the next block with the rows read so far
+};
+
+/// @brief A delimiter, quote and line break fixed at compile time
+/// A reader made for a dialect splits fields by comparing against constants. It converts to the read_options of
+/// the to_* functions, which choose a compiled dialect for the common delimiters once per file.
+template<char Delimiter, char Quote = '"', char LineBreak = '\n'>
+struct dialect
+{
+    static constexpr char delimiter = Delimiter;
+    static constexpr char quote = Quote;
+    static constexpr char lineBreak = LineBreak;
+
+    operator read_options() const
+    {
+        read_options options(delimiter);
+        options.quote = quote;
+        options.lineBreak = lineBreak;
+        return options;
+    }
+};
+
 namespace detail
 {
 
@@ -73,16 +214,31 @@ struct FilteredTypes { using type = T; };
 
 template<typename... Ts>
 struct FilteredTypes<std::tuple<Ts...>> { using type = FilteredTuple<Ts...>; };
+
+/// @brief A dialect known only at run time, with the members of csv::dialect
+struct RuntimeDialect
+{
+    char delimiter = ',';
+    char quote = '"';
+    char lineBreak = '\n';
+};
+
+template<typename T>
+struct IsRuntimeDialect : std::is_same<T, RuntimeDialect> {};
 /// @}
 
-template<typename CharT>
-char get_delimiter(std::basic_istream<CharT>& file)
+/// @brief options with the delimiter, quote and line break of a compiled dialect
+template<char Delimiter, char Quote, char LineBreak>
+read_options with_fixed_dialect(read_options options, dialect<Delimiter, Quote, LineBreak>)
 {
-    std::string line;
-    const auto position = file.tellg();
-    std::getline(file, line);
-    file.seekg(position); // rewind our line get
+    options.delimiter = Delimiter;
+    options.quote = Quote;
+    options.lineBreak = LineBreak;
+    return options;
+}
 
+inline char get_delimiter(std::string_view line)
+{
     char delimiter = ' '; // space-separated
     if (std::regex_search(line.cbegin(), line.cend(), std::regex(","))) // comma-separated
     {
@@ -100,183 +256,6552 @@ char get_delimiter(std::basic_istream<CharT>& file)
     return delimiter;
 }
 
-template<typename... Ts, size_t... indices>
-auto filter_tuple_by_sequence(std::tuple<Ts...> tup, std::index_sequence<indices...>)
+inline bool is_space(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline bool is_digit(char c)
 {
-    return std::make_tuple(std::move(std::get<indices>(tup))...);
+    return static_cast<unsigned char>(c - '0') < 10;
 }
 
-template<typename UnwantedT, typename... Ts>
-auto filter_tuple_by_type(std::tuple<Ts...> tup)
+/// @defgroup Digit parsing
+/// Eight ASCII digits are converted at once inside a 64-bit word (SWAR), and sixteen with SSE4.1 multiply-adds
+/// when the target supports it, instead of one multiply per digit.
+/// @{
+inline uint64_t read_eight_bytes(const char* p)
 {
-    return filter_tuple_by_sequence(std::move(tup), FilteredIndexSequence<UnwantedT, Ts...>{});
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
 }
 
-template<typename T, typename CharT>
-T parse_row(std::basic_istream<CharT>& row, char delimiter)
+inline bool is_eight_digits(uint64_t chunk)
 {
-    if constexpr (std::is_same_v<T, ignore>)
+    return !(((chunk + 0x4646464646464646) | (chunk - 0x3030303030303030)) & 0x8080808080808080);
+}
+
+/// @brief The value of eight ASCII digits read with read_eight_bytes
+inline uint32_t parse_eight_digits(uint64_t chunk)
+{
+    constexpr uint64_t mask = 0x000000FF000000FF;
+    constexpr uint64_t mul1 = 0x000F424000000064; // 100 + (1000000 << 32)
+    constexpr uint64_t mul2 = 0x0000271000000001; // 1 + (10000 << 32)
+    chunk -= 0x3030303030303030;
+    chunk = (chunk * 10) + (chunk >> 8); // pairs of digits
+    return static_cast<uint32_t>((((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32);
+}
+
+#if defined(__SSE4_1__)
+/// @brief Parses sixteen ASCII digits at p
+/// @return false if any of the sixteen characters is not a digit
+inline bool parse_sixteen_digits(const char* p, uint64_t& value)
+{
+    const auto digits = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), _mm_set1_epi8('0'));
+    const auto nine = _mm_set1_epi8(9);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(digits, nine), nine)) != 0xFFFF)
     {
-        row.ignore(std::numeric_limits<std::streamsize>::max(), delimiter);
-        return {};
+        return false;
     }
-    else if constexpr (std::is_same_v<T, std::string>)
+    const auto pairs = _mm_maddubs_epi16(digits, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+    const auto quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    const auto octets = _mm_madd_epi16(_mm_packus_epi32(quads, quads),
+                                       _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+    value = static_cast<uint64_t>(static_cast<uint32_t>(_mm_cvtsi128_si32(octets))) * 100000000
+            + static_cast<uint32_t>(_mm_extract_epi32(octets, 1));
+    return true;
+}
+#endif
+
+/// @brief Parses an integer from the start of [first, last), skipping leading whitespace like std::istream does and
+/// ignoring anything after the number
+/// @return false if no number was found (value is zero) or it does not fit in T (value is saturated)
+template<typename T>
+bool parse_integer(const char* first, const char* last, T& value)
+{
+    value = 0;
+    while (first != last && is_space(*first))
     {
-        std::string value;
-        std::getline(row, value, delimiter);
-        if (row.eof() && value.back() == '\r')
-        {
-            value.pop_back();
-        }
-        return value;
+        ++first;
+    }
+    const bool negative = first != last && *first == '-';
+    if (first != last && (*first == '-' || *first == '+'))
+    {
+        ++first;
+    }
+
+    const auto digitsBegin = first;
+    uint64_t magnitude = 0;
+#if defined(__SSE4_1__)
+    if (last - first >= 16 && parse_sixteen_digits(first, magnitude))
+    {
+        first += 16;
+    }
+#endif
+    constexpr uint64_t maxBeforeEightDigits = (std::numeric_limits<uint64_t>::max() - 99999999) / 100000000;
+    for (uint64_t chunk; last - first >= 8 && magnitude <= maxBeforeEightDigits
+                         && is_eight_digits(chunk = read_eight_bytes(first)); first += 8)
+    {
+        magnitude = magnitude * 100000000 + parse_eight_digits(chunk);
+    }
+    bool overflow = false;
+    for (; first != last && is_digit(*first); ++first)
+    {
+        const auto digit = static_cast<uint64_t>(*first - '0');
+        overflow |= magnitude > (std::numeric_limits<uint64_t>::max() - digit) / 10;
+        magnitude = magnitude * 10 + digit;
+    }
+    if (first == digitsBegin)
+    {
+        return false;
     }
-    else if constexpr (std::is_same_v<T, bool>)
+
+    if constexpr (std::is_signed_v<T>)
     {
-        std::string valueAsString;
-        std::getline(row, valueAsString, delimiter);
-        const auto first = valueAsString[valueAsString.find_first_of("tTfF01")];
-        return (!valueAsString.empty()
-                && (first == 't' || first == 'T' || first == '1'));
+        const auto limit = static_cast<uint64_t>(std::numeric_limits<T>::max()) + negative;
+        if (overflow || magnitude > limit)
+        {
+            value = negative ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+            return false;
+        }
+        value = negative && magnitude != 0 ? static_cast<T>(-static_cast<int64_t>(magnitude - 1) - 1)
+                                           : static_cast<T>(magnitude);
     }
     else
     {
-        T value = std::numeric_limits<T>::quiet_NaN();
-        std::string valueAsString;
-        std::getline(row, valueAsString, delimiter);
-        std::istringstream(valueAsString) >> value;
-        return value;
+        if (overflow || magnitude > std::numeric_limits<T>::max())
+        {
+            value = std::numeric_limits<T>::max();
+            return false;
+        }
+        if (negative && magnitude != 0)
+        {
+            return false;
+        }
+        value = static_cast<T>(magnitude);
     }
+    return true;
 }
+/// @}
+
+/// @defgroup Floating-point parsing
+/// Eisel-Lemire ("Number Parsing at a Gigabyte per Second", Lemire 2021): a decimal w * 10^q is converted by
+/// multiplying w with a truncated 128-bit 5^q, which yields the correctly rounded binary value unless the
+/// truncation error makes the rounding direction ambiguous. Those rare cases fall back to strtod.
+/// @{
+struct UInt128
+{
+    uint64_t high;
+    uint64_t low;
+};
 
-template<typename ...Ts, typename CharT>
-FilteredTuple<Ts...> parse_row(std::basic_istream<CharT>& row, char delimiter, std::tuple<Ts...>)
+inline UInt128 full_multiplication(uint64_t a, uint64_t b)
 {
-    auto unfilteredTuple = std::tuple<Ts...>{detail::parse_row<Ts>(row, delimiter)...};
-    return filter_tuple_by_type<ignore>(std::move(unfilteredTuple));
+#if defined(__SIZEOF_INT128__)
+    const auto product = static_cast<unsigned __int128>(a) * b;
+    return {static_cast<uint64_t>(product >> 64), static_cast<uint64_t>(product)};
+#else
+    const auto aLow = a & 0xFFFFFFFF, aHigh = a >> 32;
+    const auto bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+    const auto lowLow = aLow * bLow, highLow = aHigh * bLow, lowHigh = aLow * bHigh, highHigh = aHigh * bHigh;
+    const auto cross = (lowLow >> 32) + (highLow & 0xFFFFFFFF) + lowHigh;
+    return {highHigh + (highLow >> 32) + (cross >> 32), (cross << 32) | (lowLow & 0xFFFFFFFF)};
+#endif
 }
 
-template<typename RowT, typename CharT>
-auto parse_csv(std::basic_istream<CharT>& file, char delimiter)
+inline int leading_zeroes(uint64_t value)
 {
-    using RowOutT = std::conditional_t<IsTuple<RowT>::value, typename FilteredTypes<RowT>::type, RowT>;
-    std::vector<RowOutT> data;
-    std::string line;
-    while (std::getline(file, line))
+#if defined(__GNUC__)
+    return __builtin_clzll(value);
+#else
+    int count = 0;
+    for (auto mask = uint64_t(1) << 63; !(value & mask); mask >>= 1)
     {
-        std::istringstream stream(line);
-        RowOutT values;
-        if constexpr (IsArray<RowOutT>::value)
-        {
-            for (auto& v : values)
-            {
-                v = detail::parse_row<typename RowOutT::value_type>(stream, delimiter);
-            }
-        }
-        else if constexpr (IsTuple<RowOutT>::value)
+        ++count;
+    }
+    return count;
+#endif
+}
+
+template<typename T>
+struct FloatTraits;
+
+template<>
+struct FloatTraits<float>
+{
+    using Bits = uint32_t;
+    static constexpr int mantissaBits = 23;
+    static constexpr int minimumExponent = -127;
+    static constexpr int infinitePower = 0xFF;
+    static constexpr int smallestPowerOfTen = -65;
+    static constexpr int largestPowerOfTen = 38;
+    static constexpr int minExponentRoundToEven = -17;
+    static constexpr int maxExponentRoundToEven = 10;
+    static constexpr int maxExactPowerOfTen = 10;
+    static constexpr uint64_t maxExactMantissa = uint64_t(1) << 24;
+};
+
+template<>
+struct FloatTraits<double>
+{
+    using Bits = uint64_t;
+    static constexpr int mantissaBits = 52;
+    static constexpr int minimumExponent = -1023;
+    static constexpr int infinitePower = 0x7FF;
+    static constexpr int smallestPowerOfTen = -342;
+    static constexpr int largestPowerOfTen = 308;
+    static constexpr int minExponentRoundToEven = -4;
+    static constexpr int maxExponentRoundToEven = 23;
+    static constexpr int maxExactPowerOfTen = 22;
+    static constexpr uint64_t maxExactMantissa = uint64_t(1) << 53;
+};
+
+/// @brief 5^q for q in [-342, 308], normalized so the most significant bit is set and truncated to 128 bits
+inline constexpr int smallestPowerOfFive = -342;
+inline constexpr UInt128 powersOfFive[] = {
+    {0xeef453d6923bd65a, 0x113faa2906a13b3f},
+    {0x9558b4661b6565f8, 0x4ac7ca59a424c507},
+    {0xbaaee17fa23ebf76, 0x5d79bcf00d2df649},
+    {0xe95a99df8ace6f53, 0xf4d82c2c107973dc},
+    {0x91d8a02bb6c10594, 0x79071b9b8a4be869},
+    {0xb64ec836a47146f9, 0x9748e2826cdee284},
+    {0xe3e27a444d8d98b7, 0xfd1b1b2308169b25},
+    {0x8e6d8c6ab0787f72, 0xfe30f0f5e50e20f7},
+    {0xb208ef855c969f4f, 0xbdbd2d335e51a935},
+    {0xde8b2b66b3bc4723, 0xad2c788035e61382},
+    {0x8b16fb203055ac76, 0x4c3bcb5021afcc31},
+    {0xaddcb9e83c6b1793, 0xdf4abe242a1bbf3d},
+    {0xd953e8624b85dd78, 0xd71d6dad34a2af0d},
+    {0x87d4713d6f33aa6b, 0x8672648c40e5ad68},
+    {0xa9c98d8ccb009506, 0x680efdaf511f18c2},
+    {0xd43bf0effdc0ba48, 0x0212bd1b2566def2},
+    {0x84a57695fe98746d, 0x014bb630f7604b57},
+    {0xa5ced43b7e3e9188, 0x419ea3bd35385e2d},
+    {0xcf42894a5dce35ea, 0x52064cac828675b9},
+    {0x818995ce7aa0e1b2, 0x7343efebd1940993},
+    {0xa1ebfb4219491a1f, 0x1014ebe6c5f90bf8},
+    {0xca66fa129f9b60a6, 0xd41a26e077774ef6},
+    {0xfd00b897478238d0, 0x8920b098955522b4},
+    {0x9e20735e8cb16382, 0x55b46e5f5d5535b0},
+    {0xc5a890362fddbc62, 0xeb2189f734aa831d},
+    {0xf712b443bbd52b7b, 0xa5e9ec7501d523e4},
+    {0x9a6bb0aa55653b2d, 0x47b233c92125366e},
+    {0xc1069cd4eabe89f8, 0x999ec0bb696e840a},
+    {0xf148440a256e2c76, 0xc00670ea43ca250d},
+    {0x96cd2a865764dbca, 0x380406926a5e5728},
+    {0xbc807527ed3e12bc, 0xc605083704f5ecf2},
+    {0xeba09271e88d976b, 0xf7864a44c633682e},
+    {0x93445b8731587ea3, 0x7ab3ee6afbe0211d},
+    {0xb8157268fdae9e4c, 0x5960ea05bad82964},
+    {0xe61acf033d1a45df, 0x6fb92487298e33bd},
+    {0x8fd0c16206306bab, 0xa5d3b6d479f8e056},
+    {0xb3c4f1ba87bc8696, 0x8f48a4899877186c},
+    {0xe0b62e2929aba83c, 0x331acdabfe94de87},
+    {0x8c71dcd9ba0b4925, 0x9ff0c08b7f1d0b14},
+    {0xaf8e5410288e1b6f, 0x07ecf0ae5ee44dd9},
+    {0xdb71e91432b1a24a, 0xc9e82cd9f69d6150},
+    {0x892731ac9faf056e, 0xbe311c083a225cd2},
+    {0xab70fe17c79ac6ca, 0x6dbd630a48aaf406},
+    {0xd64d3d9db981787d, 0x092cbbccdad5b108},
+    {0x85f0468293f0eb4e, 0x25bbf56008c58ea5},
+    {0xa76c582338ed2621, 0xaf2af2b80af6f24e},
+    {0xd1476e2c07286faa, 0x1af5af660db4aee1},
+    {0x82cca4db847945ca, 0x50d98d9fc890ed4d},
+    {0xa37fce126597973c, 0xe50ff107bab528a0},
+    {0xcc5fc196fefd7d0c, 0x1e53ed49a96272c8},
+    {0xff77b1fcbebcdc4f, 0x25e8e89c13bb0f7a},
+    {0x9faacf3df73609b1, 0x77b191618c54e9ac},
+    {0xc795830d75038c1d, 0xd59df5b9ef6a2417},
+    {0xf97ae3d0d2446f25, 0x4b0573286b44ad1d},
+    {0x9becce62836ac577, 0x4ee367f9430aec32},
+    {0xc2e801fb244576d5, 0x229c41f793cda73f},
+    {0xf3a20279ed56d48a, 0x6b43527578c1110f},
+    {0x9845418c345644d6, 0x830a13896b78aaa9},
+    {0xbe5691ef416bd60c, 0x23cc986bc656d553},
+    {0xedec366b11c6cb8f, 0x2cbfbe86b7ec8aa8},
+    {0x94b3a202eb1c3f39, 0x7bf7d71432f3d6a9},
+    {0xb9e08a83a5e34f07, 0xdaf5ccd93fb0cc53},
+    {0xe858ad248f5c22c9, 0xd1b3400f8f9cff68},
+    {0x91376c36d99995be, 0x23100809b9c21fa1},
+    {0xb58547448ffffb2d, 0xabd40a0c2832a78a},
+    {0xe2e69915b3fff9f9, 0x16c90c8f323f516c},
+    {0x8dd01fad907ffc3b, 0xae3da7d97f6792e3},
+    {0xb1442798f49ffb4a, 0x99cd11cfdf41779c},
+    {0xdd95317f31c7fa1d, 0x40405643d711d583},
+    {0x8a7d3eef7f1cfc52, 0x482835ea666b2572},
+    {0xad1c8eab5ee43b66, 0xda3243650005eecf},
+    {0xd863b256369d4a40, 0x90bed43e40076a82},
+    {0x873e4f75e2224e68, 0x5a7744a6e804a291},
+    {0xa90de3535aaae202, 0x711515d0a205cb36},
+    {0xd3515c2831559a83, 0x0d5a5b44ca873e03},
+    {0x8412d9991ed58091, 0xe858790afe9486c2},
+    {0xa5178fff668ae0b6, 0x626e974dbe39a872},
+    {0xce5d73ff402d98e3, 0xfb0a3d212dc8128f},
+    {0x80fa687f881c7f8e, 0x7ce66634bc9d0b99},
+    {0xa139029f6a239f72, 0x1c1fffc1ebc44e80},
+    {0xc987434744ac874e, 0xa327ffb266b56220},
+    {0xfbe9141915d7a922, 0x4bf1ff9f0062baa8},
+    {0x9d71ac8fada6c9b5, 0x6f773fc3603db4a9},
+    {0xc4ce17b399107c22, 0xcb550fb4384d21d3},
+    {0xf6019da07f549b2b, 0x7e2a53a146606a48},
+    {0x99c102844f94e0fb, 0x2eda7444cbfc426d},
+    {0xc0314325637a1939, 0xfa911155fefb5308},
+    {0xf03d93eebc589f88, 0x793555ab7eba27ca},
+    {0x96267c7535b763b5, 0x4bc1558b2f3458de},
+    {0xbbb01b9283253ca2, 0x9eb1aaedfb016f16},
+    {0xea9c227723ee8bcb, 0x465e15a979c1cadc},
+    {0x92a1958a7675175f, 0x0bfacd89ec191ec9},
+    {0xb749faed14125d36, 0xcef980ec671f667b},
+    {0xe51c79a85916f484, 0x82b7e12780e7401a},
+    {0x8f31cc0937ae58d2, 0xd1b2ecb8b0908810},
+    {0xb2fe3f0b8599ef07, 0x861fa7e6dcb4aa15},
+    {0xdfbdcece67006ac9, 0x67a791e093e1d49a},
+    {0x8bd6a141006042bd, 0xe0c8bb2c5c6d24e0},
+    {0xaecc49914078536d, 0x58fae9f773886e18},
+    {0xda7f5bf590966848, 0xaf39a475506a899e},
+    {0x888f99797a5e012d, 0x6d8406c952429603},
+    {0xaab37fd7d8f58178, 0xc8e5087ba6d33b83},
+    {0xd5605fcdcf32e1d6, 0xfb1e4a9a90880a64},
+    {0x855c3be0a17fcd26, 0x5cf2eea09a55067f},
+    {0xa6b34ad8c9dfc06f, 0xf42faa48c0ea481e},
+    {0xd0601d8efc57b08b, 0xf13b94daf124da26},
+    {0x823c12795db6ce57, 0x76c53d08d6b70858},
+    {0xa2cb1717b52481ed, 0x54768c4b0c64ca6e},
+    {0xcb7ddcdda26da268, 0xa9942f5dcf7dfd09},
+    {0xfe5d54150b090b02, 0xd3f93b35435d7c4c},
+    {0x9efa548d26e5a6e1, 0xc47bc5014a1a6daf},
+    {0xc6b8e9b0709f109a, 0x359ab6419ca1091b},
+    {0xf867241c8cc6d4c0, 0xc30163d203c94b62},
+    {0x9b407691d7fc44f8, 0x79e0de63425dcf1d},
+    {0xc21094364dfb5636, 0x985915fc12f542e4},
+    {0xf294b943e17a2bc4, 0x3e6f5b7b17b2939d},
+    {0x979cf3ca6cec5b5a, 0xa705992ceecf9c42},
+    {0xbd8430bd08277231, 0x50c6ff782a838353},
+    {0xece53cec4a314ebd, 0xa4f8bf5635246428},
+    {0x940f4613ae5ed136, 0x871b7795e136be99},
+    {0xb913179899f68584, 0x28e2557b59846e3f},
+    {0xe757dd7ec07426e5, 0x331aeada2fe589cf},
+    {0x9096ea6f3848984f, 0x3ff0d2c85def7621},
+    {0xb4bca50b065abe63, 0x0fed077a756b53a9},
+    {0xe1ebce4dc7f16dfb, 0xd3e8495912c62894},
+    {0x8d3360f09cf6e4bd, 0x64712dd7abbbd95c},
+    {0xb080392cc4349dec, 0xbd8d794d96aacfb3},
+    {0xdca04777f541c567, 0xecf0d7a0fc5583a0},
+    {0x89e42caaf9491b60, 0xf41686c49db57244},
+    {0xac5d37d5b79b6239, 0x311c2875c522ced5},
+    {0xd77485cb25823ac7, 0x7d633293366b828b},
+    {0x86a8d39ef77164bc, 0xae5dff9c02033197},
+    {0xa8530886b54dbdeb, 0xd9f57f830283fdfc},
+    {0xd267caa862a12d66, 0xd072df63c324fd7b},
+    {0x8380dea93da4bc60, 0x4247cb9e59f71e6d},
+    {0xa46116538d0deb78, 0x52d9be85f074e608},
+    {0xcd795be870516656, 0x67902e276c921f8b},
+    {0x806bd9714632dff6, 0x00ba1cd8a3db53b6},
+    {0xa086cfcd97bf97f3, 0x80e8a40eccd228a4},
+    {0xc8a883c0fdaf7df0, 0x6122cd128006b2cd},
+    {0xfad2a4b13d1b5d6c, 0x796b805720085f81},
+    {0x9cc3a6eec6311a63, 0xcbe3303674053bb0},
+    {0xc3f490aa77bd60fc, 0xbedbfc4411068a9c},
+    {0xf4f1b4d515acb93b, 0xee92fb5515482d44},
+    {0x991711052d8bf3c5, 0x751bdd152d4d1c4a},
+    {0xbf5cd54678eef0b6, 0xd262d45a78a0635d},
+    {0xef340a98172aace4, 0x86fb897116c87c34},
+    {0x9580869f0e7aac0e, 0xd45d35e6ae3d4da0},
+    {0xbae0a846d2195712, 0x8974836059cca109},
+    {0xe998d258869facd7, 0x2bd1a438703fc94b},
+    {0x91ff83775423cc06, 0x7b6306a34627ddcf},
+    {0xb67f6455292cbf08, 0x1a3bc84c17b1d542},
+    {0xe41f3d6a7377eeca, 0x20caba5f1d9e4a93},
+    {0x8e938662882af53e, 0x547eb47b7282ee9c},
+    {0xb23867fb2a35b28d, 0xe99e619a4f23aa43},
+    {0xdec681f9f4c31f31, 0x6405fa00e2ec94d4},
+    {0x8b3c113c38f9f37e, 0xde83bc408dd3dd04},
+    {0xae0b158b4738705e, 0x9624ab50b148d445},
+    {0xd98ddaee19068c76, 0x3badd624dd9b0957},
+    {0x87f8a8d4cfa417c9, 0xe54ca5d70a80e5d6},
+    {0xa9f6d30a038d1dbc, 0x5e9fcf4ccd211f4c},
+    {0xd47487cc8470652b, 0x7647c3200069671f},
+    {0x84c8d4dfd2c63f3b, 0x29ecd9f40041e073},
+    {0xa5fb0a17c777cf09, 0xf468107100525890},
+    {0xcf79cc9db955c2cc, 0x7182148d4066eeb4},
+    {0x81ac1fe293d599bf, 0xc6f14cd848405530},
+    {0xa21727db38cb002f, 0xb8ada00e5a506a7c},
+    {0xca9cf1d206fdc03b, 0xa6d90811f0e4851c},
+    {0xfd442e4688bd304a, 0x908f4a166d1da663},
+    {0x9e4a9cec15763e2e, 0x9a598e4e043287fe},
+    {0xc5dd44271ad3cdba, 0x40eff1e1853f29fd},
+    {0xf7549530e188c128, 0xd12bee59e68ef47c},
+    {0x9a94dd3e8cf578b9, 0x82bb74f8301958ce},
+    {0xc13a148e3032d6e7, 0xe36a52363c1faf01},
+    {0xf18899b1bc3f8ca1, 0xdc44e6c3cb279ac1},
+    {0x96f5600f15a7b7e5, 0x29ab103a5ef8c0b9},
+    {0xbcb2b812db11a5de, 0x7415d448f6b6f0e7},
+    {0xebdf661791d60f56, 0x111b495b3464ad21},
+    {0x936b9fcebb25c995, 0xcab10dd900beec34},
+    {0xb84687c269ef3bfb, 0x3d5d514f40eea742},
+    {0xe65829b3046b0afa, 0x0cb4a5a3112a5112},
+    {0x8ff71a0fe2c2e6dc, 0x47f0e785eaba72ab},
+    {0xb3f4e093db73a093, 0x59ed216765690f56},
+    {0xe0f218b8d25088b8, 0x306869c13ec3532c},
+    {0x8c974f7383725573, 0x1e414218c73a13fb},
+    {0xafbd2350644eeacf, 0xe5d1929ef90898fa},
+    {0xdbac6c247d62a583, 0xdf45f746b74abf39},
+    {0x894bc396ce5da772, 0x6b8bba8c328eb783},
+    {0xab9eb47c81f5114f, 0x066ea92f3f326564},
+    {0xd686619ba27255a2, 0xc80a537b0efefebd},
+    {0x8613fd0145877585, 0xbd06742ce95f5f36},
+    {0xa798fc4196e952e7, 0x2c48113823b73704},
+    {0xd17f3b51fca3a7a0, 0xf75a15862ca504c5},
+    {0x82ef85133de648c4, 0x9a984d73dbe722fb},
+    {0xa3ab66580d5fdaf5, 0xc13e60d0d2e0ebba},
+    {0xcc963fee10b7d1b3, 0x318df905079926a8},
+    {0xffbbcfe994e5c61f, 0xfdf17746497f7052},
+    {0x9fd561f1fd0f9bd3, 0xfeb6ea8bedefa633},
+    {0xc7caba6e7c5382c8, 0xfe64a52ee96b8fc0},
+    {0xf9bd690a1b68637b, 0x3dfdce7aa3c673b0},
+    {0x9c1661a651213e2d, 0x06bea10ca65c084e},
+    {0xc31bfa0fe5698db8, 0x486e494fcff30a62},
+    {0xf3e2f893dec3f126, 0x5a89dba3c3efccfa},
+    {0x986ddb5c6b3a76b7, 0xf89629465a75e01c},
+    {0xbe89523386091465, 0xf6bbb397f1135823},
+    {0xee2ba6c0678b597f, 0x746aa07ded582e2c},
+    {0x94db483840b717ef, 0xa8c2a44eb4571cdc},
+    {0xba121a4650e4ddeb, 0x92f34d62616ce413},
+    {0xe896a0d7e51e1566, 0x77b020baf9c81d17},
+    {0x915e2486ef32cd60, 0x0ace1474dc1d122e},
+    {0xb5b5ada8aaff80b8, 0x0d819992132456ba},
+    {0xe3231912d5bf60e6, 0x10e1fff697ed6c69},
+    {0x8df5efabc5979c8f, 0xca8d3ffa1ef463c1},
+    {0xb1736b96b6fd83b3, 0xbd308ff8a6b17cb2},
+    {0xddd0467c64bce4a0, 0xac7cb3f6d05ddbde},
+    {0x8aa22c0dbef60ee4, 0x6bcdf07a423aa96b},
+    {0xad4ab7112eb3929d, 0x86c16c98d2c953c6},
+    {0xd89d64d57a607744, 0xe871c7bf077ba8b7},
+    {0x87625f056c7c4a8b, 0x11471cd764ad4972},
+    {0xa93af6c6c79b5d2d, 0xd598e40d3dd89bcf},
+    {0xd389b47879823479, 0x4aff1d108d4ec2c3},
+    {0x843610cb4bf160cb, 0xcedf722a585139ba},
+    {0xa54394fe1eedb8fe, 0xc2974eb4ee658828},
+    {0xce947a3da6a9273e, 0x733d226229feea32},
+    {0x811ccc668829b887, 0x0806357d5a3f525f},
+    {0xa163ff802a3426a8, 0xca07c2dcb0cf26f7},
+    {0xc9bcff6034c13052, 0xfc89b393dd02f0b5},
+    {0xfc2c3f3841f17c67, 0xbbac2078d443ace2},
+    {0x9d9ba7832936edc0, 0xd54b944b84aa4c0d},
+    {0xc5029163f384a931, 0x0a9e795e65d4df11},
+    {0xf64335bcf065d37d, 0x4d4617b5ff4a16d5},
+    {0x99ea0196163fa42e, 0x504bced1bf8e4e45},
+    {0xc06481fb9bcf8d39, 0xe45ec2862f71e1d6},
+    {0xf07da27a82c37088, 0x5d767327bb4e5a4c},
+    {0x964e858c91ba2655, 0x3a6a07f8d510f86f},
+    {0xbbe226efb628afea, 0x890489f70a55368b},
+    {0xeadab0aba3b2dbe5, 0x2b45ac74ccea842e},
+    {0x92c8ae6b464fc96f, 0x3b0b8bc90012929d},
+    {0xb77ada0617e3bbcb, 0x09ce6ebb40173744},
+    {0xe55990879ddcaabd, 0xcc420a6a101d0515},
+    {0x8f57fa54c2a9eab6, 0x9fa946824a12232d},
+    {0xb32df8e9f3546564, 0x47939822dc96abf9},
+    {0xdff9772470297ebd, 0x59787e2b93bc56f7},
+    {0x8bfbea76c619ef36, 0x57eb4edb3c55b65a},
+    {0xaefae51477a06b03, 0xede622920b6b23f1},
+    {0xdab99e59958885c4, 0xe95fab368e45eced},
+    {0x88b402f7fd75539b, 0x11dbcb0218ebb414},
+    {0xaae103b5fcd2a881, 0xd652bdc29f26a119},
+    {0xd59944a37c0752a2, 0x4be76d3346f0495f},
+    {0x857fcae62d8493a5, 0x6f70a4400c562ddb},
+    {0xa6dfbd9fb8e5b88e, 0xcb4ccd500f6bb952},
+    {0xd097ad07a71f26b2, 0x7e2000a41346a7a7},
+    {0x825ecc24c873782f, 0x8ed400668c0c28c8},
+    {0xa2f67f2dfa90563b, 0x728900802f0f32fa},
+    {0xcbb41ef979346bca, 0x4f2b40a03ad2ffb9},
+    {0xfea126b7d78186bc, 0xe2f610c84987bfa8},
+    {0x9f24b832e6b0f436, 0x0dd9ca7d2df4d7c9},
+    {0xc6ede63fa05d3143, 0x91503d1c79720dbb},
+    {0xf8a95fcf88747d94, 0x75a44c6397ce912a},
+    {0x9b69dbe1b548ce7c, 0xc986afbe3ee11aba},
+    {0xc24452da229b021b, 0xfbe85badce996168},
+    {0xf2d56790ab41c2a2, 0xfae27299423fb9c3},
+    {0x97c560ba6b0919a5, 0xdccd879fc967d41a},
+    {0xbdb6b8e905cb600f, 0x5400e987bbc1c920},
+    {0xed246723473e3813, 0x290123e9aab23b68},
+    {0x9436c0760c86e30b, 0xf9a0b6720aaf6521},
+    {0xb94470938fa89bce, 0xf808e40e8d5b3e69},
+    {0xe7958cb87392c2c2, 0xb60b1d1230b20e04},
+    {0x90bd77f3483bb9b9, 0xb1c6f22b5e6f48c2},
+    {0xb4ecd5f01a4aa828, 0x1e38aeb6360b1af3},
+    {0xe2280b6c20dd5232, 0x25c6da63c38de1b0},
+    {0x8d590723948a535f, 0x579c487e5a38ad0e},
+    {0xb0af48ec79ace837, 0x2d835a9df0c6d851},
+    {0xdcdb1b2798182244, 0xf8e431456cf88e65},
+    {0x8a08f0f8bf0f156b, 0x1b8e9ecb641b58ff},
+    {0xac8b2d36eed2dac5, 0xe272467e3d222f3f},
+    {0xd7adf884aa879177, 0x5b0ed81dcc6abb0f},
+    {0x86ccbb52ea94baea, 0x98e947129fc2b4e9},
+    {0xa87fea27a539e9a5, 0x3f2398d747b36224},
+    {0xd29fe4b18e88640e, 0x8eec7f0d19a03aad},
+    {0x83a3eeeef9153e89, 0x1953cf68300424ac},
+    {0xa48ceaaab75a8e2b, 0x5fa8c3423c052dd7},
+    {0xcdb02555653131b6, 0x3792f412cb06794d},
+    {0x808e17555f3ebf11, 0xe2bbd88bbee40bd0},
+    {0xa0b19d2ab70e6ed6, 0x5b6aceaeae9d0ec4},
+    {0xc8de047564d20a8b, 0xf245825a5a445275},
+    {0xfb158592be068d2e, 0xeed6e2f0f0d56712},
+    {0x9ced737bb6c4183d, 0x55464dd69685606b},
+    {0xc428d05aa4751e4c, 0xaa97e14c3c26b886},
+    {0xf53304714d9265df, 0xd53dd99f4b3066a8},
+    {0x993fe2c6d07b7fab, 0xe546a8038efe4029},
+    {0xbf8fdb78849a5f96, 0xde98520472bdd033},
+    {0xef73d256a5c0f77c, 0x963e66858f6d4440},
+    {0x95a8637627989aad, 0xdde7001379a44aa8},
+    {0xbb127c53b17ec159, 0x5560c018580d5d52},
+    {0xe9d71b689dde71af, 0xaab8f01e6e10b4a6},
+    {0x9226712162ab070d, 0xcab3961304ca70e8},
+    {0xb6b00d69bb55c8d1, 0x3d607b97c5fd0d22},
+    {0xe45c10c42a2b3b05, 0x8cb89a7db77c506a},
+    {0x8eb98a7a9a5b04e3, 0x77f3608e92adb242},
+    {0xb267ed1940f1c61c, 0x55f038b237591ed3},
+    {0xdf01e85f912e37a3, 0x6b6c46dec52f6688},
+    {0x8b61313bbabce2c6, 0x2323ac4b3b3da015},
+    {0xae397d8aa96c1b77, 0xabec975e0a0d081a},
+    {0xd9c7dced53c72255, 0x96e7bd358c904a21},
+    {0x881cea14545c7575, 0x7e50d64177da2e54},
+    {0xaa242499697392d2, 0xdde50bd1d5d0b9e9},
+    {0xd4ad2dbfc3d07787, 0x955e4ec64b44e864},
+    {0x84ec3c97da624ab4, 0xbd5af13bef0b113e},
+    {0xa6274bbdd0fadd61, 0xecb1ad8aeacdd58e},
+    {0xcfb11ead453994ba, 0x67de18eda5814af2},
+    {0x81ceb32c4b43fcf4, 0x80eacf948770ced7},
+    {0xa2425ff75e14fc31, 0xa1258379a94d028d},
+    {0xcad2f7f5359a3b3e, 0x096ee45813a04330},
+    {0xfd87b5f28300ca0d, 0x8bca9d6e188853fc},
+    {0x9e74d1b791e07e48, 0x775ea264cf55347e},
+    {0xc612062576589dda, 0x95364afe032a819e},
+    {0xf79687aed3eec551, 0x3a83ddbd83f52205},
+    {0x9abe14cd44753b52, 0xc4926a9672793543},
+    {0xc16d9a0095928a27, 0x75b7053c0f178294},
+    {0xf1c90080baf72cb1, 0x5324c68b12dd6339},
+    {0x971da05074da7bee, 0xd3f6fc16ebca5e04},
+    {0xbce5086492111aea, 0x88f4bb1ca6bcf585},
+    {0xec1e4a7db69561a5, 0x2b31e9e3d06c32e6},
+    {0x9392ee8e921d5d07, 0x3aff322e62439fd0},
+    {0xb877aa3236a4b449, 0x09befeb9fad487c3},
+    {0xe69594bec44de15b, 0x4c2ebe687989a9b4},
+    {0x901d7cf73ab0acd9, 0x0f9d37014bf60a11},
+    {0xb424dc35095cd80f, 0x538484c19ef38c95},
+    {0xe12e13424bb40e13, 0x2865a5f206b06fba},
+    {0x8cbccc096f5088cb, 0xf93f87b7442e45d4},
+    {0xafebff0bcb24aafe, 0xf78f69a51539d749},
+    {0xdbe6fecebdedd5be, 0xb573440e5a884d1c},
+    {0x89705f4136b4a597, 0x31680a88f8953031},
+    {0xabcc77118461cefc, 0xfdc20d2b36ba7c3e},
+    {0xd6bf94d5e57a42bc, 0x3d32907604691b4d},
+    {0x8637bd05af6c69b5, 0xa63f9a49c2c1b110},
+    {0xa7c5ac471b478423, 0x0fcf80dc33721d54},
+    {0xd1b71758e219652b, 0xd3c36113404ea4a9},
+    {0x83126e978d4fdf3b, 0x645a1cac083126ea},
+    {0xa3d70a3d70a3d70a, 0x3d70a3d70a3d70a4},
+    {0xcccccccccccccccc, 0xcccccccccccccccd},
+    {0x8000000000000000, 0x0000000000000000},
+    {0xa000000000000000, 0x0000000000000000},
+    {0xc800000000000000, 0x0000000000000000},
+    {0xfa00000000000000, 0x0000000000000000},
+    {0x9c40000000000000, 0x0000000000000000},
+    {0xc350000000000000, 0x0000000000000000},
+    {0xf424000000000000, 0x0000000000000000},
+    {0x9896800000000000, 0x0000000000000000},
+    {0xbebc200000000000, 0x0000000000000000},
+    {0xee6b280000000000, 0x0000000000000000},
+    {0x9502f90000000000, 0x0000000000000000},
+    {0xba43b74000000000, 0x0000000000000000},
+    {0xe8d4a51000000000, 0x0000000000000000},
+    {0x9184e72a00000000, 0x0000000000000000},
+    {0xb5e620f480000000, 0x0000000000000000},
+    {0xe35fa931a0000000, 0x0000000000000000},
+    {0x8e1bc9bf04000000, 0x0000000000000000},
+    {0xb1a2bc2ec5000000, 0x0000000000000000},
+    {0xde0b6b3a76400000, 0x0000000000000000},
+    {0x8ac7230489e80000, 0x0000000000000000},
+    {0xad78ebc5ac620000, 0x0000000000000000},
+    {0xd8d726b7177a8000, 0x0000000000000000},
+    {0x878678326eac9000, 0x0000000000000000},
+    {0xa968163f0a57b400, 0x0000000000000000},
+    {0xd3c21bcecceda100, 0x0000000000000000},
+    {0x84595161401484a0, 0x0000000000000000},
+    {0xa56fa5b99019a5c8, 0x0000000000000000},
+    {0xcecb8f27f4200f3a, 0x0000000000000000},
+    {0x813f3978f8940984, 0x4000000000000000},
+    {0xa18f07d736b90be5, 0x5000000000000000},
+    {0xc9f2c9cd04674ede, 0xa400000000000000},
+    {0xfc6f7c4045812296, 0x4d00000000000000},
+    {0x9dc5ada82b70b59d, 0xf020000000000000},
+    {0xc5371912364ce305, 0x6c28000000000000},
+    {0xf684df56c3e01bc6, 0xc732000000000000},
+    {0x9a130b963a6c115c, 0x3c7f400000000000},
+    {0xc097ce7bc90715b3, 0x4b9f100000000000},
+    {0xf0bdc21abb48db20, 0x1e86d40000000000},
+    {0x96769950b50d88f4, 0x1314448000000000},
+    {0xbc143fa4e250eb31, 0x17d955a000000000},
+    {0xeb194f8e1ae525fd, 0x5dcfab0800000000},
+    {0x92efd1b8d0cf37be, 0x5aa1cae500000000},
+    {0xb7abc627050305ad, 0xf14a3d9e40000000},
+    {0xe596b7b0c643c719, 0x6d9ccd05d0000000},
+    {0x8f7e32ce7bea5c6f, 0xe4820023a2000000},
+    {0xb35dbf821ae4f38b, 0xdda2802c8a800000},
+    {0xe0352f62a19e306e, 0xd50b2037ad200000},
+    {0x8c213d9da502de45, 0x4526f422cc340000},
+    {0xaf298d050e4395d6, 0x9670b12b7f410000},
+    {0xdaf3f04651d47b4c, 0x3c0cdd765f114000},
+    {0x88d8762bf324cd0f, 0xa5880a69fb6ac800},
+    {0xab0e93b6efee0053, 0x8eea0d047a457a00},
+    {0xd5d238a4abe98068, 0x72a4904598d6d880},
+    {0x85a36366eb71f041, 0x47a6da2b7f864750},
+    {0xa70c3c40a64e6c51, 0x999090b65f67d924},
+    {0xd0cf4b50cfe20765, 0xfff4b4e3f741cf6d},
+    {0x82818f1281ed449f, 0xbff8f10e7a8921a4},
+    {0xa321f2d7226895c7, 0xaff72d52192b6a0d},
+    {0xcbea6f8ceb02bb39, 0x9bf4f8a69f764490},
+    {0xfee50b7025c36a08, 0x02f236d04753d5b4},
+    {0x9f4f2726179a2245, 0x01d762422c946590},
+    {0xc722f0ef9d80aad6, 0x424d3ad2b7b97ef5},
+    {0xf8ebad2b84e0d58b, 0xd2e0898765a7deb2},
+    {0x9b934c3b330c8577, 0x63cc55f49f88eb2f},
+    {0xc2781f49ffcfa6d5, 0x3cbf6b71c76b25fb},
+    {0xf316271c7fc3908a, 0x8bef464e3945ef7a},
+    {0x97edd871cfda3a56, 0x97758bf0e3cbb5ac},
+    {0xbde94e8e43d0c8ec, 0x3d52eeed1cbea317},
+    {0xed63a231d4c4fb27, 0x4ca7aaa863ee4bdd},
+    {0x945e455f24fb1cf8, 0x8fe8caa93e74ef6a},
+    {0xb975d6b6ee39e436, 0xb3e2fd538e122b44},
+    {0xe7d34c64a9c85d44, 0x60dbbca87196b616},
+    {0x90e40fbeea1d3a4a, 0xbc8955e946fe31cd},
+    {0xb51d13aea4a488dd, 0x6babab6398bdbe41},
+    {0xe264589a4dcdab14, 0xc696963c7eed2dd1},
+    {0x8d7eb76070a08aec, 0xfc1e1de5cf543ca2},
+    {0xb0de65388cc8ada8, 0x3b25a55f43294bcb},
+    {0xdd15fe86affad912, 0x49ef0eb713f39ebe},
+    {0x8a2dbf142dfcc7ab, 0x6e3569326c784337},
+    {0xacb92ed9397bf996, 0x49c2c37f07965404},
+    {0xd7e77a8f87daf7fb, 0xdc33745ec97be906},
+    {0x86f0ac99b4e8dafd, 0x69a028bb3ded71a3},
+    {0xa8acd7c0222311bc, 0xc40832ea0d68ce0c},
+    {0xd2d80db02aabd62b, 0xf50a3fa490c30190},
+    {0x83c7088e1aab65db, 0x792667c6da79e0fa},
+    {0xa4b8cab1a1563f52, 0x577001b891185938},
+    {0xcde6fd5e09abcf26, 0xed4c0226b55e6f86},
+    {0x80b05e5ac60b6178, 0x544f8158315b05b4},
+    {0xa0dc75f1778e39d6, 0x696361ae3db1c721},
+    {0xc913936dd571c84c, 0x03bc3a19cd1e38e9},
+    {0xfb5878494ace3a5f, 0x04ab48a04065c723},
+    {0x9d174b2dcec0e47b, 0x62eb0d64283f9c76},
+    {0xc45d1df942711d9a, 0x3ba5d0bd324f8394},
+    {0xf5746577930d6500, 0xca8f44ec7ee36479},
+    {0x9968bf6abbe85f20, 0x7e998b13cf4e1ecb},
+    {0xbfc2ef456ae276e8, 0x9e3fedd8c321a67e},
+    {0xefb3ab16c59b14a2, 0xc5cfe94ef3ea101e},
+    {0x95d04aee3b80ece5, 0xbba1f1d158724a12},
+    {0xbb445da9ca61281f, 0x2a8a6e45ae8edc97},
+    {0xea1575143cf97226, 0xf52d09d71a3293bd},
+    {0x924d692ca61be758, 0x593c2626705f9c56},
+    {0xb6e0c377cfa2e12e, 0x6f8b2fb00c77836c},
+    {0xe498f455c38b997a, 0x0b6dfb9c0f956447},
+    {0x8edf98b59a373fec, 0x4724bd4189bd5eac},
+    {0xb2977ee300c50fe7, 0x58edec91ec2cb657},
+    {0xdf3d5e9bc0f653e1, 0x2f2967b66737e3ed},
+    {0x8b865b215899f46c, 0xbd79e0d20082ee74},
+    {0xae67f1e9aec07187, 0xecd8590680a3aa11},
+    {0xda01ee641a708de9, 0xe80e6f4820cc9495},
+    {0x884134fe908658b2, 0x3109058d147fdcdd},
+    {0xaa51823e34a7eede, 0xbd4b46f0599fd415},
+    {0xd4e5e2cdc1d1ea96, 0x6c9e18ac7007c91a},
+    {0x850fadc09923329e, 0x03e2cf6bc604ddb0},
+    {0xa6539930bf6bff45, 0x84db8346b786151c},
+    {0xcfe87f7cef46ff16, 0xe612641865679a63},
+    {0x81f14fae158c5f6e, 0x4fcb7e8f3f60c07e},
+    {0xa26da3999aef7749, 0xe3be5e330f38f09d},
+    {0xcb090c8001ab551c, 0x5cadf5bfd3072cc5},
+    {0xfdcb4fa002162a63, 0x73d9732fc7c8f7f6},
+    {0x9e9f11c4014dda7e, 0x2867e7fddcdd9afa},
+    {0xc646d63501a1511d, 0xb281e1fd541501b8},
+    {0xf7d88bc24209a565, 0x1f225a7ca91a4226},
+    {0x9ae757596946075f, 0x3375788de9b06958},
+    {0xc1a12d2fc3978937, 0x0052d6b1641c83ae},
+    {0xf209787bb47d6b84, 0xc0678c5dbd23a49a},
+    {0x9745eb4d50ce6332, 0xf840b7ba963646e0},
+    {0xbd176620a501fbff, 0xb650e5a93bc3d898},
+    {0xec5d3fa8ce427aff, 0xa3e51f138ab4cebe},
+    {0x93ba47c980e98cdf, 0xc66f336c36b10137},
+    {0xb8a8d9bbe123f017, 0xb80b0047445d4184},
+    {0xe6d3102ad96cec1d, 0xa60dc059157491e5},
+    {0x9043ea1ac7e41392, 0x87c89837ad68db2f},
+    {0xb454e4a179dd1877, 0x29babe4598c311fb},
+    {0xe16a1dc9d8545e94, 0xf4296dd6fef3d67a},
+    {0x8ce2529e2734bb1d, 0x1899e4a65f58660c},
+    {0xb01ae745b101e9e4, 0x5ec05dcff72e7f8f},
+    {0xdc21a1171d42645d, 0x76707543f4fa1f73},
+    {0x899504ae72497eba, 0x6a06494a791c53a8},
+    {0xabfa45da0edbde69, 0x0487db9d17636892},
+    {0xd6f8d7509292d603, 0x45a9d2845d3c42b6},
+    {0x865b86925b9bc5c2, 0x0b8a2392ba45a9b2},
+    {0xa7f26836f282b732, 0x8e6cac7768d7141e},
+    {0xd1ef0244af2364ff, 0x3207d795430cd926},
+    {0x8335616aed761f1f, 0x7f44e6bd49e807b8},
+    {0xa402b9c5a8d3a6e7, 0x5f16206c9c6209a6},
+    {0xcd036837130890a1, 0x36dba887c37a8c0f},
+    {0x802221226be55a64, 0xc2494954da2c9789},
+    {0xa02aa96b06deb0fd, 0xf2db9baa10b7bd6c},
+    {0xc83553c5c8965d3d, 0x6f92829494e5acc7},
+    {0xfa42a8b73abbf48c, 0xcb772339ba1f17f9},
+    {0x9c69a97284b578d7, 0xff2a760414536efb},
+    {0xc38413cf25e2d70d, 0xfef5138519684aba},
+    {0xf46518c2ef5b8cd1, 0x7eb258665fc25d69},
+    {0x98bf2f79d5993802, 0xef2f773ffbd97a61},
+    {0xbeeefb584aff8603, 0xaafb550ffacfd8fa},
+    {0xeeaaba2e5dbf6784, 0x95ba2a53f983cf38},
+    {0x952ab45cfa97a0b2, 0xdd945a747bf26183},
+    {0xba756174393d88df, 0x94f971119aeef9e4},
+    {0xe912b9d1478ceb17, 0x7a37cd5601aab85d},
+    {0x91abb422ccb812ee, 0xac62e055c10ab33a},
+    {0xb616a12b7fe617aa, 0x577b986b314d6009},
+    {0xe39c49765fdf9d94, 0xed5a7e85fda0b80b},
+    {0x8e41ade9fbebc27d, 0x14588f13be847307},
+    {0xb1d219647ae6b31c, 0x596eb2d8ae258fc8},
+    {0xde469fbd99a05fe3, 0x6fca5f8ed9aef3bb},
+    {0x8aec23d680043bee, 0x25de7bb9480d5854},
+    {0xada72ccc20054ae9, 0xaf561aa79a10ae6a},
+    {0xd910f7ff28069da4, 0x1b2ba1518094da04},
+    {0x87aa9aff79042286, 0x90fb44d2f05d0842},
+    {0xa99541bf57452b28, 0x353a1607ac744a53},
+    {0xd3fa922f2d1675f2, 0x42889b8997915ce8},
+    {0x847c9b5d7c2e09b7, 0x69956135febada11},
+    {0xa59bc234db398c25, 0x43fab9837e699095},
+    {0xcf02b2c21207ef2e, 0x94f967e45e03f4bb},
+    {0x8161afb94b44f57d, 0x1d1be0eebac278f5},
+    {0xa1ba1ba79e1632dc, 0x6462d92a69731732},
+    {0xca28a291859bbf93, 0x7d7b8f7503cfdcfe},
+    {0xfcb2cb35e702af78, 0x5cda735244c3d43e},
+    {0x9defbf01b061adab, 0x3a0888136afa64a7},
+    {0xc56baec21c7a1916, 0x088aaa1845b8fdd0},
+    {0xf6c69a72a3989f5b, 0x8aad549e57273d45},
+    {0x9a3c2087a63f6399, 0x36ac54e2f678864b},
+    {0xc0cb28a98fcf3c7f, 0x84576a1bb416a7dd},
+    {0xf0fdf2d3f3c30b9f, 0x656d44a2a11c51d5},
+    {0x969eb7c47859e743, 0x9f644ae5a4b1b325},
+    {0xbc4665b596706114, 0x873d5d9f0dde1fee},
+    {0xeb57ff22fc0c7959, 0xa90cb506d155a7ea},
+    {0x9316ff75dd87cbd8, 0x09a7f12442d588f2},
+    {0xb7dcbf5354e9bece, 0x0c11ed6d538aeb2f},
+    {0xe5d3ef282a242e81, 0x8f1668c8a86da5fa},
+    {0x8fa475791a569d10, 0xf96e017d694487bc},
+    {0xb38d92d760ec4455, 0x37c981dcc395a9ac},
+    {0xe070f78d3927556a, 0x85bbe253f47b1417},
+    {0x8c469ab843b89562, 0x93956d7478ccec8e},
+    {0xaf58416654a6babb, 0x387ac8d1970027b2},
+    {0xdb2e51bfe9d0696a, 0x06997b05fcc0319e},
+    {0x88fcf317f22241e2, 0x441fece3bdf81f03},
+    {0xab3c2fddeeaad25a, 0xd527e81cad7626c3},
+    {0xd60b3bd56a5586f1, 0x8a71e223d8d3b074},
+    {0x85c7056562757456, 0xf6872d5667844e49},
+    {0xa738c6bebb12d16c, 0xb428f8ac016561db},
+    {0xd106f86e69d785c7, 0xe13336d701beba52},
+    {0x82a45b450226b39c, 0xecc0024661173473},
+    {0xa34d721642b06084, 0x27f002d7f95d0190},
+    {0xcc20ce9bd35c78a5, 0x31ec038df7b441f4},
+    {0xff290242c83396ce, 0x7e67047175a15271},
+    {0x9f79a169bd203e41, 0x0f0062c6e984d386},
+    {0xc75809c42c684dd1, 0x52c07b78a3e60868},
+    {0xf92e0c3537826145, 0xa7709a56ccdf8a82},
+    {0x9bbcc7a142b17ccb, 0x88a66076400bb691},
+    {0xc2abf989935ddbfe, 0x6acff893d00ea435},
+    {0xf356f7ebf83552fe, 0x0583f6b8c4124d43},
+    {0x98165af37b2153de, 0xc3727a337a8b704a},
+    {0xbe1bf1b059e9a8d6, 0x744f18c0592e4c5c},
+    {0xeda2ee1c7064130c, 0x1162def06f79df73},
+    {0x9485d4d1c63e8be7, 0x8addcb5645ac2ba8},
+    {0xb9a74a0637ce2ee1, 0x6d953e2bd7173692},
+    {0xe8111c87c5c1ba99, 0xc8fa8db6ccdd0437},
+    {0x910ab1d4db9914a0, 0x1d9c9892400a22a2},
+    {0xb54d5e4a127f59c8, 0x2503beb6d00cab4b},
+    {0xe2a0b5dc971f303a, 0x2e44ae64840fd61d},
+    {0x8da471a9de737e24, 0x5ceaecfed289e5d2},
+    {0xb10d8e1456105dad, 0x7425a83e872c5f47},
+    {0xdd50f1996b947518, 0xd12f124e28f77719},
+    {0x8a5296ffe33cc92f, 0x82bd6b70d99aaa6f},
+    {0xace73cbfdc0bfb7b, 0x636cc64d1001550b},
+    {0xd8210befd30efa5a, 0x3c47f7e05401aa4e},
+    {0x8714a775e3e95c78, 0x65acfaec34810a71},
+    {0xa8d9d1535ce3b396, 0x7f1839a741a14d0d},
+    {0xd31045a8341ca07c, 0x1ede48111209a050},
+    {0x83ea2b892091e44d, 0x934aed0aab460432},
+    {0xa4e4b66b68b65d60, 0xf81da84d5617853f},
+    {0xce1de40642e3f4b9, 0x36251260ab9d668e},
+    {0x80d2ae83e9ce78f3, 0xc1d72b7c6b426019},
+    {0xa1075a24e4421730, 0xb24cf65b8612f81f},
+    {0xc94930ae1d529cfc, 0xdee033f26797b627},
+    {0xfb9b7cd9a4a7443c, 0x169840ef017da3b1},
+    {0x9d412e0806e88aa5, 0x8e1f289560ee864e},
+    {0xc491798a08a2ad4e, 0xf1a6f2bab92a27e2},
+    {0xf5b5d7ec8acb58a2, 0xae10af696774b1db},
+    {0x9991a6f3d6bf1765, 0xacca6da1e0a8ef29},
+    {0xbff610b0cc6edd3f, 0x17fd090a58d32af3},
+    {0xeff394dcff8a948e, 0xddfc4b4cef07f5b0},
+    {0x95f83d0a1fb69cd9, 0x4abdaf101564f98e},
+    {0xbb764c4ca7a4440f, 0x9d6d1ad41abe37f1},
+    {0xea53df5fd18d5513, 0x84c86189216dc5ed},
+    {0x92746b9be2f8552c, 0x32fd3cf5b4e49bb4},
+    {0xb7118682dbb66a77, 0x3fbc8c33221dc2a1},
+    {0xe4d5e82392a40515, 0x0fabaf3feaa5334a},
+    {0x8f05b1163ba6832d, 0x29cb4d87f2a7400e},
+    {0xb2c71d5bca9023f8, 0x743e20e9ef511012},
+    {0xdf78e4b2bd342cf6, 0x914da9246b255416},
+    {0x8bab8eefb6409c1a, 0x1ad089b6c2f7548e},
+    {0xae9672aba3d0c320, 0xa184ac2473b529b1},
+    {0xda3c0f568cc4f3e8, 0xc9e5d72d90a2741e},
+    {0x8865899617fb1871, 0x7e2fa67c7a658892},
+    {0xaa7eebfb9df9de8d, 0xddbb901b98feeab7},
+    {0xd51ea6fa85785631, 0x552a74227f3ea565},
+    {0x8533285c936b35de, 0xd53a88958f87275f},
+    {0xa67ff273b8460356, 0x8a892abaf368f137},
+    {0xd01fef10a657842c, 0x2d2b7569b0432d85},
+    {0x8213f56a67f6b29b, 0x9c3b29620e29fc73},
+    {0xa298f2c501f45f42, 0x8349f3ba91b47b8f},
+    {0xcb3f2f7642717713, 0x241c70a936219a73},
+    {0xfe0efb53d30dd4d7, 0xed238cd383aa0110},
+    {0x9ec95d1463e8a506, 0xf4363804324a40aa},
+    {0xc67bb4597ce2ce48, 0xb143c6053edcd0d5},
+    {0xf81aa16fdc1b81da, 0xdd94b7868e94050a},
+    {0x9b10a4e5e9913128, 0xca7cf2b4191c8326},
+    {0xc1d4ce1f63f57d72, 0xfd1c2f611f63a3f0},
+    {0xf24a01a73cf2dccf, 0xbc633b39673c8cec},
+    {0x976e41088617ca01, 0xd5be0503e085d813},
+    {0xbd49d14aa79dbc82, 0x4b2d8644d8a74e18},
+    {0xec9c459d51852ba2, 0xddf8e7d60ed1219e},
+    {0x93e1ab8252f33b45, 0xcabb90e5c942b503},
+    {0xb8da1662e7b00a17, 0x3d6a751f3b936243},
+    {0xe7109bfba19c0c9d, 0x0cc512670a783ad4},
+    {0x906a617d450187e2, 0x27fb2b80668b24c5},
+    {0xb484f9dc9641e9da, 0xb1f9f660802dedf6},
+    {0xe1a63853bbd26451, 0x5e7873f8a0396973},
+    {0x8d07e33455637eb2, 0xdb0b487b6423e1e8},
+    {0xb049dc016abc5e5f, 0x91ce1a9a3d2cda62},
+    {0xdc5c5301c56b75f7, 0x7641a140cc7810fb},
+    {0x89b9b3e11b6329ba, 0xa9e904c87fcb0a9d},
+    {0xac2820d9623bf429, 0x546345fa9fbdcd44},
+    {0xd732290fbacaf133, 0xa97c177947ad4095},
+    {0x867f59a9d4bed6c0, 0x49ed8eabcccc485d},
+    {0xa81f301449ee8c70, 0x5c68f256bfff5a74},
+    {0xd226fc195c6a2f8c, 0x73832eec6fff3111},
+    {0x83585d8fd9c25db7, 0xc831fd53c5ff7eab},
+    {0xa42e74f3d032f525, 0xba3e7ca8b77f5e55},
+    {0xcd3a1230c43fb26f, 0x28ce1bd2e55f35eb},
+    {0x80444b5e7aa7cf85, 0x7980d163cf5b81b3},
+    {0xa0555e361951c366, 0xd7e105bcc332621f},
+    {0xc86ab5c39fa63440, 0x8dd9472bf3fefaa7},
+    {0xfa856334878fc150, 0xb14f98f6f0feb951},
+    {0x9c935e00d4b9d8d2, 0x6ed1bf9a569f33d3},
+    {0xc3b8358109e84f07, 0x0a862f80ec4700c8},
+    {0xf4a642e14c6262c8, 0xcd27bb612758c0fa},
+    {0x98e7e9cccfbd7dbd, 0x8038d51cb897789c},
+    {0xbf21e44003acdd2c, 0xe0470a63e6bd56c3},
+    {0xeeea5d5004981478, 0x1858ccfce06cac74},
+    {0x95527a5202df0ccb, 0x0f37801e0c43ebc8},
+    {0xbaa718e68396cffd, 0xd30560258f54e6ba},
+    {0xe950df20247c83fd, 0x47c6b82ef32a2069},
+    {0x91d28b7416cdd27e, 0x4cdc331d57fa5441},
+    {0xb6472e511c81471d, 0xe0133fe4adf8e952},
+    {0xe3d8f9e563a198e5, 0x58180fddd97723a6},
+    {0x8e679c2f5e44ff8f, 0x570f09eaa7ea7648},
+};
+
+/// @brief Binary significand and biased exponent; power2 < 0 means the result could not be decided
+struct AdjustedMantissa
+{
+    uint64_t mantissa = 0;
+    int power2 = 0;
+
+    bool operator==(const AdjustedMantissa& other) const
+    {
+        return mantissa == other.mantissa && power2 == other.power2;
+    }
+
+    bool operator!=(const AdjustedMantissa& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/// @brief w * 5^q, accurate to at least bitPrecision leading bits unless the low word saturates
+template<int bitPrecision>
+UInt128 compute_product_approximation(int64_t q, uint64_t w)
+{
+    const auto index = static_cast<size_t>(q - smallestPowerOfFive);
+    constexpr uint64_t precisionMask = ~uint64_t(0) >> bitPrecision;
+    auto product = full_multiplication(w, powersOfFive[index].high);
+    if ((product.high & precisionMask) == precisionMask)
+    {
+        const auto second = full_multiplication(w, powersOfFive[index].low);
+        product.low += second.high;
+        if (second.high > product.low)
         {
-            values = detail::parse_row(stream, delimiter, RowT{});
+            ++product.high;
         }
-        else
+    }
+    return product;
+}
+
+/// @brief Converts w * 10^q to a binary significand and exponent
+template<typename T>
+AdjustedMantissa compute_float(int64_t q, uint64_t w)
+{
+    using Traits = FloatTraits<T>;
+    AdjustedMantissa answer;
+    if (w == 0 || q < Traits::smallestPowerOfTen)
+    {
+        return answer;
+    }
+    if (q > Traits::largestPowerOfTen)
+    {
+        answer.power2 = Traits::infinitePower;
+        return answer;
+    }
+
+    const auto lz = leading_zeroes(w);
+    w <<= lz;
+    const auto product = compute_product_approximation<Traits::mantissaBits + 3>(q, w);
+    if (product.low == ~uint64_t(0) && (q < -27 || q > 55))
+    {
+        // The truncated power of five may have lost the bits that decide the rounding
+        answer.power2 = -1;
+        return answer;
+    }
+
+    const auto upperBit = static_cast<int>(product.high >> 63);
+    const auto shift = upperBit + 64 - Traits::mantissaBits - 3;
+    answer.mantissa = product.high >> shift;
+    // floor(log2(10^q)) + 63 == ((217706 * q) >> 16) + 63
+    const auto power = static_cast<int>(((152170 + 65536) * q) >> 16) + 63;
+    answer.power2 = power + upperBit - lz - Traits::minimumExponent;
+    if (answer.power2 <= 0) // subnormal
+    {
+        if (-answer.power2 + 1 >= 64)
         {
-            while (!stream.eof())
-            {
-                values.push_back(detail::parse_row<typename RowOutT::value_type>(stream, delimiter));
-            }
+            answer = {};
+            return answer;
         }
-        data.push_back(std::move(values));
+        answer.mantissa >>= -answer.power2 + 1;
+        answer.mantissa += (answer.mantissa & 1);
+        answer.mantissa >>= 1;
+        // Rounding may carry into the smallest normal
+        answer.power2 = answer.mantissa < (uint64_t(1) << Traits::mantissaBits) ? 0 : 1;
+        return answer;
     }
-    return data;
+
+    // Exactly halfway between two floats: round to even instead of up
+    if (product.low <= 1 && q >= Traits::minExponentRoundToEven && q <= Traits::maxExponentRoundToEven
+        && (answer.mantissa & 3) == 1 && (answer.mantissa << shift) == product.high)
+    {
+        answer.mantissa &= ~uint64_t(1);
+    }
+
+    answer.mantissa += (answer.mantissa & 1);
+    answer.mantissa >>= 1;
+    if (answer.mantissa >= (uint64_t(2) << Traits::mantissaBits))
+    {
+        answer.mantissa = uint64_t(1) << Traits::mantissaBits;
+        ++answer.power2;
+    }
+    answer.mantissa &= ~(uint64_t(1) << Traits::mantissaBits);
+    if (answer.power2 >= Traits::infinitePower)
+    {
+        answer = {0, Traits::infinitePower};
+    }
+    return answer;
 }
 
-template<typename ContainerT>
-ContainerT get_header(std::ifstream& file, char delimiter)
+template<typename T>
+T to_float(AdjustedMantissa value, bool negative)
 {
-    std::string line;
-    std::getline(file, line);
-    std::istringstream stream(line);
-    return detail::parse_csv<ContainerT>(stream, delimiter).front();
+    using Bits = typename FloatTraits<T>::Bits;
+    auto bits = static_cast<Bits>(value.mantissa)
+                | static_cast<Bits>(value.power2) << FloatTraits<T>::mantissaBits
+                | static_cast<Bits>(negative) << (sizeof(Bits) * 8 - 1);
+    T result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
 }
 
-template<typename ContainerT, typename HeaderT = ignore>
-auto to_containers(std::string_view& path, char delimiter, HeaderT&& header = {})
+/// @brief Case-insensitive match of a lowercase word at the start of [first, last)
+inline bool starts_with_word(const char* first, const char* last, std::string_view word)
 {
-    // Open file
-    auto file = std::ifstream(path.data());
-    if (file)
+    if (static_cast<size_t>(last - first) < word.size())
     {
-        // Check delimiter
-        if (delimiter == '\0')
-        {
-            delimiter = detail::get_delimiter(file);
-        }
-        // Read header
-        if constexpr (!std::is_same_v<HeaderT, ignore>)
+        return false;
+    }
+    for (const auto c : word)
+    {
+        if ((*first++ | 0x20) != c)
         {
-            header = detail::get_header<std::decay_t<HeaderT>>(file, delimiter);
+            return false;
         }
-        // Read CSV
-        return detail::parse_csv<ContainerT>(file, delimiter);
     }
-    return decltype(detail::parse_csv<ContainerT>(file, delimiter)){};
+    return true;
 }
-} // namespace detail
 
-std::vector<std::string> get_header(std::string_view path, char delimiter = '\0')
+/// @brief Parses a floating-point number from the start of [first, last), skipping leading whitespace like
+/// std::istream does and ignoring anything after the number
+/// @return false if no number was found, in which case value is zero
+template<typename T>
+bool parse_float(const char* first, const char* last, T& value)
 {
-    // Open file
-    if (auto file = std::ifstream(path.data()))
+    if constexpr (std::numeric_limits<T>::digits == std::numeric_limits<double>::digits && !std::is_same_v<T, double>)
     {
-        // Check delimiter
-        if (delimiter == '\0')
+        // long double is an alias of double on some platforms
+        double result;
+        const auto parsed = parse_float(first, last, result);
+        value = static_cast<T>(result);
+        return parsed;
+    }
+    else
+    {
+        value = 0;
+        while (first != last && is_space(*first))
         {
-            delimiter = detail::get_delimiter(file);
+            ++first;
         }
-        // Read header
-        return detail::get_header<std::vector<std::string>>(file, delimiter);
+        const auto start = first;
+        const bool negative = first != last && *first == '-';
+        if (first != last && (*first == '-' || *first == '+'))
+        {
+            ++first;
+        }
+
+        uint64_t mantissa = 0; // wraps if there are more than 19 digits, which is corrected below
+        const auto integerBegin = first;
+        for (; first != last && is_digit(*first); ++first)
+        {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*first - '0');
+        }
+        const auto integerEnd = first;
+        auto nDigits = integerEnd - integerBegin;
+        int64_t exponent = 0;
+        auto fractionBegin = first, fractionEnd = first;
+        if (first != last && *first == '.')
+        {
+            fractionBegin = ++first;
+            for (uint64_t chunk; last - first >= 8 && is_eight_digits(chunk = read_eight_bytes(first)); first += 8)
+            {
+                mantissa = mantissa * 100000000 + parse_eight_digits(chunk);
+            }
+            for (; first != last && is_digit(*first); ++first)
+            {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*first - '0');
+            }
+            fractionEnd = first;
+            exponent = fractionBegin - fractionEnd;
+            nDigits += fractionEnd - fractionBegin;
+        }
+        if (nDigits == 0)
+        {
+            if (starts_with_word(first, last, "inf"))
+            {
+                value = negative ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+                return true;
+            }
+            if (starts_with_word(first, last, "nan"))
+            {
+                value = std::numeric_limits<T>::quiet_NaN();
+                return true;
+            }
+            return false;
+        }
+
+        int64_t explicitExponent = 0;
+        if (first != last && (*first | 0x20) == 'e')
+        {
+            auto p = first + 1;
+            const bool negativeExponent = p != last && *p == '-';
+            if (p != last && (*p == '-' || *p == '+'))
+            {
+                ++p;
+            }
+            if (p != last && is_digit(*p))
+            {
+                for (; p != last && is_digit(*p); ++p)
+                {
+                    if (explicitExponent < 0x10000000)
+                    {
+                        explicitExponent = explicitExponent * 10 + (*p - '0');
+                    }
+                }
+                explicitExponent = negativeExponent ? -explicitExponent : explicitExponent;
+                first = p;
+            }
+        }
+        exponent += explicitExponent;
+
+        // Only 19 significant digits fit in the mantissa; keep those and remember that the rest were dropped
+        bool truncated = false;
+        if (nDigits > 19)
+        {
+            for (auto p = integerBegin; p != fractionEnd && (*p == '0' || *p == '.'); ++p)
+            {
+                nDigits -= *p == '0';
+            }
+            if (nDigits > 19)
+            {
+                truncated = true;
+                constexpr uint64_t minimal19DigitInteger = 1000000000000000000;
+                mantissa = 0;
+                auto p = integerBegin;
+                for (; mantissa < minimal19DigitInteger && p != integerEnd; ++p)
+                {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                }
+                if (mantissa >= minimal19DigitInteger)
+                {
+                    exponent = (integerEnd - p) + explicitExponent;
+                }
+                else
+                {
+                    for (p = fractionBegin; mantissa < minimal19DigitInteger && p != fractionEnd; ++p)
+                    {
+                        mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                    }
+                    exponent = (fractionBegin - p) + explicitExponent;
+                }
+            }
+        }
+
+        if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+        {
+            using Traits = FloatTraits<T>;
+            // Clinger's fast path: both operands are exact, so a single rounding gives the right answer
+            if (!truncated && mantissa <= Traits::maxExactMantissa
+                && exponent >= -Traits::maxExactPowerOfTen && exponent <= Traits::maxExactPowerOfTen)
+            {
+                constexpr T powersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                             1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+                value = static_cast<T>(mantissa);
+                value = exponent < 0 ? value / powersOfTen[-exponent] : value * powersOfTen[exponent];
+                value = negative ? -value : value;
+                return true;
+            }
+
+            auto answer = compute_float<T>(exponent, mantissa);
+            if (truncated && answer.power2 >= 0 && answer != compute_float<T>(exponent, mantissa + 1))
+            {
+                answer.power2 = -1;
+            }
+            if (answer.power2 >= 0)
+            {
+                value = to_float<T>(answer, negative);
+                return true;
+            }
+        }
+
+        else if constexpr (std::numeric_limits<T>::digits >= 64)
+        {
+            // Extended long double: any 19 digits and 10^27 are exact, so Clinger's fast path goes further
+            if (!truncated && exponent >= -27 && exponent <= 27)
+            {
+                T powerOfTen = 1;
+                for (auto i = exponent < 0 ? -exponent : exponent; i > 0; --i)
+                {
+                    powerOfTen *= 10;
+                }
+                value = static_cast<T>(mantissa);
+                value = exponent < 0 ? value / powerOfTen : value * powerOfTen;
+                value = negative ? -value : value;
+                return true;
+            }
+        }
+
+        // Undecided by Eisel-Lemire, or out of range for the fast paths: let the C library round the digits
+        const auto length = static_cast<size_t>(first - start);
+        char small[64];
+        std::string large;
+        char* text = small;
+        if (length >= sizeof(small))
+        {
+            large.assign(start, length);
+            text = large.data();
+        }
+        else
+        {
+            std::memcpy(small, start, length);
+            small[length] = '\0';
+        }
+        if constexpr (std::is_same_v<T, float>) value = std::strtof(text, nullptr);
+        else if constexpr (std::is_same_v<T, double>) value = std::strtod(text, nullptr);
+        else value = std::strtold(text, nullptr);
+        return true;
     }
-    return {};
 }
+/// @}
 
-template<typename ValueT, size_t nColumns>
-std::vector<std::array<ValueT, nColumns>> to_arrays(std::string_view path, char delimiter = '\0')
+/// @brief Parses true/false, yes/no, 1/0 or their first letters (case-insensitive) from the start of [first, last),
+/// skipping leading whitespace; the first significant character decides the value
+/// @return false if the field is not one of the recognized words, in which case value may still be set
+inline bool parse_bool(const char* first, const char* last, bool& value)
 {
-    return detail::to_containers<std::array<ValueT, nColumns>>(path, delimiter);
+    while (first != last && is_space(*first))
+    {
+        ++first;
+    }
+    value = false;
+    if (first == last)
+    {
+        return false;
+    }
+    std::string_view word;
+    const auto isLetter = static_cast<unsigned>((*first | 0x20) - 'a') < 26;
+    switch (isLetter ? *first | 0x20 : *first) // lowercase letters only, or control bytes would pass for digits
+    {
+        case 't': value = true; word = "true"; break;
+        case 'y': value = true; word = "yes"; break;
+        case '1': value = true; word = "1"; break;
+        case 'f': word = "false"; break;
+        case 'n': word = "no"; break;
+        case '0': word = "0"; break;
+        default: return false;
+    }
+    // Single letters such as Y/N or T/F are accepted too
+    const bool singleCharacter = first + 1 == last
+                                 || !(is_digit(first[1]) || static_cast<unsigned>((first[1] | 0x20) - 'a') < 26);
+    return singleCharacter || starts_with_word(first, last, word);
 }
 
-template<typename ValueT, size_t nColumns>
-std::vector<std::array<ValueT, nColumns>> to_arrays(std::string_view path,
-                                                    std::array<std::string, nColumns>& header,
-                                                    char delimiter = '\0')
+/// @brief Parses the value at the start of field, skipping leading whitespace like std::istream does
+/// @return false if field does not start with a valid value
+template<typename T>
+bool parse_value(std::string_view field, T& value)
 {
-    return detail::to_containers<std::array<ValueT, nColumns>>(path, delimiter, header);
+    if constexpr (std::is_same_v<T, bool>)
+    {
+        return parse_bool(field.data(), field.data() + field.size(), value);
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        return parse_float(field.data(), field.data() + field.size(), value);
+    }
+    else if constexpr (std::is_integral_v<T> && sizeof(T) > 1)
+    {
+        return parse_integer(field.data(), field.data() + field.size(), value);
+    }
+    else
+    {
+        // Character types read a single character, as with std::istream
+        value = {};
+        std::istringstream stream{std::string(field)};
+        return static_cast<bool>(stream >> value);
+    }
 }
 
-template<typename... ColumnTs>
-std::vector<FilteredTuple<ColumnTs...>> to_tuples(std::string_view path, char delimiter = '\0')
+/// @brief Walks the fields of a single record
+struct RecordCursor
+{
+    std::string_view remaining;
+    bool end = false;  ///< set once the last field has been taken
+    size_t column = 0; ///< index of the next field
+};
+
+/// @brief Takes the next field off the record, quotes included
+template<typename Dialect>
+std::string_view next_field(RecordCursor& record, const Dialect& dialect)
 {
-    return detail::to_containers<std::tuple<ColumnTs...>>(path, delimiter);
+    auto& remaining = record.remaining;
+    size_t end = 0;
+    if (!remaining.empty() && remaining.front() == dialect.quote)
+    {
+        // Delimiters inside quotes belong to the field; "" is an escaped quote
+        for (end = remaining.find(dialect.quote, 1);
+             end != remaining.npos && end + 1 < remaining.size() && remaining[end + 1] == dialect.quote;
+             end = remaining.find(dialect.quote, end + 2))
+        {
+        }
+        end = end == remaining.npos ? remaining.size() : end + 1;
+    }
+    end = remaining.find(dialect.delimiter, end);
+    const auto field = remaining.substr(0, end);
+    ++record.column;
+    if (end == remaining.npos)
+    {
+        remaining = {};
+        record.end = true;
+    }
+    else
+    {
+        remaining.remove_prefix(end + 1);
+    }
+    return field;
 }
 
-template<typename... ColumnTs, size_t nColumns = std::tuple_size_v<FilteredTuple<ColumnTs...>>>
-std::vector<FilteredTuple<ColumnTs...>> to_tuples(std::string_view path,
-                                                  std::array<std::string, nColumns>& header,
-                                                  char delimiter = '\0')
+/// @brief The contents of a quoted field with escaped quotes resolved, or the field itself if it is not quoted
+inline std::string unquote(std::string_view field, char quote = '"')
 {
-    return detail::to_containers<std::tuple<ColumnTs...>>(path, delimiter, header);
+    if (field.empty() || field.front() != quote)
+    {
+        return std::string(field);
+    }
+    std::string value;
+    value.reserve(field.size());
+    for (size_t i = 1; i < field.size(); ++i)
+    {
+        if (field[i] == quote)
+        {
+            if (i + 1 == field.size() || field[i + 1] != quote)
+            {
+                break;
+            }
+            ++i;
+        }
+        value.push_back(field[i]);
+    }
+    return value;
 }
 
-template<typename ValueT>
-std::vector<std::vector<ValueT>> to_vectors(std::string_view path, char delimiter = '\0')
+/// @brief The contents of a quoted field that cannot contain escaped quotes, such as a number
+inline std::string_view strip_quotes(std::string_view field, char quote = '"')
 {
-    return detail::to_containers<std::vector<ValueT>>(path, delimiter);
+    if (field.empty() || field.front() != quote)
+    {
+        return field;
+    }
+    field.remove_prefix(1);
+    return field.substr(0, field.find(quote));
 }
 
-template<typename ValueT>
-std::vector<std::vector<ValueT>> to_vectors(std::string_view path,
-                                            std::vector<std::string>& header,
-                                            char delimiter = '\0')
+/// @brief Accumulates parse_stats; the disabled specialization compiles to nothing
+template<bool enabled>
+class Instrument
 {
-    return detail::to_containers<std::vector<ValueT>>(path, delimiter, header);
+public:
+    explicit Instrument(parse_stats* = nullptr) { }
+
+    void lap(std::chrono::nanoseconds parse_stats::*) { }
+
+    void field(size_t, bool) { }
+
+    void allocations(size_t) { }
+
+    void bytes(size_t) { }
+};
+
+template<>
+class Instrument<true>
+{
+public:
+    explicit Instrument(parse_stats* stats) : stats(stats) { }
+
+    /// @brief Charges the time since the previous lap to stage
+    void lap(std::chrono::nanoseconds parse_stats::* stage)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        stats->*stage += now - last;
+        last = now;
+    }
+
+    void field(size_t column, bool converted)
+    {
+        ++stats->fields;
+        if (stats->conversionFailures.size() <= column)
+        {
+            stats->conversionFailures.resize(column + 1);
+        }
+        stats->conversionFailures[column] += !converted;
+    }
+
+    void allocations(size_t count)
+    {
+        stats->allocations += count;
+    }
+
+    void bytes(size_t count)
+    {
+        stats->bytesRead += count;
+    }
+
+private:
+    parse_stats* stats;
+    std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+};
+
+/// @brief Takes the next field off the row and converts it into value
+template<typename T, typename Dialect, bool withStats>
+void parse_field(RecordCursor& row, const Dialect& dialect, T& value, Instrument<withStats>& instrument)
+{
+    const auto column = row.column;
+    const auto field = next_field(row, dialect);
+    instrument.lap(&parse_stats::tokenizeTime);
+    if constexpr (std::is_same_v<T, ignore>)
+    {
+        instrument.field(column, true);
+    }
+    else if constexpr (std::is_same_v<T, std::string>)
+    {
+        value = unquote(field, dialect.quote);
+        instrument.lap(&parse_stats::convertTime);
+        instrument.field(column, true);
+        instrument.allocations(value.capacity() > std::string().capacity());
+    }
+    else
+    {
+        const auto converted = parse_value(strip_quotes(field, dialect.quote), value);
+        instrument.lap(&parse_stats::convertTime);
+        instrument.field(column, converted);
+    }
+}
+
+template<typename T, typename Dialect, bool withStats = false>
+T parse_row(RecordCursor& row, const Dialect& dialect, Instrument<withStats>& instrument)
+{
+    T value;
+    parse_field(row, dialect, value, instrument);
+    return value;
+}
+
+/// @brief Passes over count fields of ignored columns
+template<typename Dialect, bool withStats>
+void skip_fields(RecordCursor& row, const Dialect& dialect, size_t count, Instrument<withStats>& instrument)
+{
+    for (; count > 0; --count)
+    {
+        const auto column = row.column;
+        next_field(row, dialect);
+        instrument.field(column, true);
+    }
+    instrument.lap(&parse_stats::tokenizeTime);
+}
+
+/// @brief The number of ignored columns just before the retained column written to values[output]
+template<size_t... columns>
+constexpr size_t ignored_before(size_t output)
+{
+    constexpr std::array<size_t, sizeof...(columns)> inputs{columns...};
+    return output == 0 ? inputs[0] : inputs[output] - inputs[output - 1] - 1;
+}
+
+/// @brief Parses a row straight into the retained columns of a tuple; each run of ignored columns is passed over
+/// before the retained column after it, and the ignored columns after the last retained one are not looked at
+template<typename RowOutT, typename Dialect, bool withStats, size_t... outputs, size_t... columns>
+void parse_columns(RecordCursor& row,
+                   const Dialect& dialect,
+                   RowOutT& values,
+                   Instrument<withStats>& instrument,
+                   std::index_sequence<outputs...>,
+                   std::index_sequence<columns...>)
+{
+    ((skip_fields(row, dialect, std::integral_constant<size_t, ignored_before<columns...>(outputs)>{}, instrument),
+      parse_field(row, dialect, std::get<outputs>(values), instrument)), ...);
+}
+
+template<typename ...Ts, typename Dialect, bool withStats>
+void parse_row(RecordCursor& row,
+               const Dialect& dialect,
+               std::tuple<Ts...>,
+               FilteredTuple<Ts...>& values,
+               Instrument<withStats>& instrument)
+{
+    parse_columns(row, dialect, values, instrument,
+                  std::make_index_sequence<std::tuple_size_v<FilteredTuple<Ts...>>>{},
+                  FilteredIndexSequence<ignore, Ts...>{});
+}
+
+template<typename RowT>
+using RowOutT = std::conditional_t<IsTuple<RowT>::value, typename FilteredTypes<RowT>::type, RowT>;
+
+/// @brief Parses a record into values, which are default-constructed
+template<typename RowT, typename Dialect, bool withStats>
+void parse_record(std::string_view record,
+                  const Dialect& dialect,
+                  RowOutT<RowT>& values,
+                  Instrument<withStats>& instrument)
+{
+    RecordCursor row{record};
+    if constexpr (IsArray<RowOutT<RowT>>::value)
+    {
+        for (auto& v : values)
+        {
+            detail::parse_field(row, dialect, v, instrument);
+        }
+    }
+    else if constexpr (IsTuple<RowOutT<RowT>>::value)
+    {
+        detail::parse_row(row, dialect, RowT{}, values, instrument);
+    }
+    else
+    {
+        do
+        {
+            const auto capacity = values.capacity();
+            values.emplace_back();
+            instrument.allocations(values.capacity() != capacity);
+            instrument.lap(&parse_stats::growthTime);
+            detail::parse_field(row, dialect, values.back(), instrument);
+        } while (!row.end);
+    }
+}
+
+template<typename RowT, typename Dialect, bool withStats>
+auto parse_record(std::string_view record, const Dialect& dialect, Instrument<withStats>& instrument)
+{
+    RowOutT<RowT> values;
+    parse_record<RowT>(record, dialect, values, instrument);
+    return values;
+}
+
+template<typename RowT, typename Dialect>
+auto parse_record(std::string_view record, const Dialect& dialect)
+{
+    Instrument<false> instrument;
+    return parse_record<RowT>(record, dialect, instrument);
+}
+
+template<typename RowT>
+auto parse_record(std::string_view record, char delimiter)
+{
+    return parse_record<RowT>(record, RuntimeDialect{delimiter});
+}
+
+/// @defgroup Byte scanning
+/// @{
+inline int count_bits(uint64_t bits)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(bits);
+#else
+    int count = 0;
+    for (; bits; bits &= bits - 1)
+    {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+inline int trailing_zeroes(uint64_t bits)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(bits);
+#else
+    int count = 0;
+    for (; !(bits & 1); bits >>= 1)
+    {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+/// @brief Bit i is set where block[i] == c, for the 64 bytes at block
+inline uint64_t match_mask(const char* block, char c)
+{
+#if defined(__AVX2__)
+    const auto needle = _mm256_set1_epi8(c);
+    const auto low = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)), needle);
+    const auto high = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32)), needle);
+    return static_cast<uint32_t>(_mm256_movemask_epi8(low))
+           | static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(high))) << 32;
+#elif defined(__SSE2__)
+    const auto needle = _mm_set1_epi8(c);
+    uint64_t mask = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+        const auto matches = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, needle)));
+        mask |= static_cast<uint64_t>(matches) << (16 * i);
+    }
+    return mask;
+#else
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; ++i)
+    {
+        mask |= static_cast<uint64_t>(block[i] == c) << i;
+    }
+    return mask;
+#endif
+}
+
+/// @brief Finds the first occurrence of needle in [first, last)
+/// Whole 64-byte blocks are compared against the first and the last byte of needle at once, and only positions
+/// where both match are compared in full.
+/// @return The occurrence, or nullptr if there is none
+inline const char* find_substring(const char* first, const char* last, std::string_view needle)
+{
+    const auto size = needle.size();
+    if (size == 0)
+    {
+        return first;
+    }
+    for (; last - first >= static_cast<std::ptrdiff_t>(size - 1 + 64); first += 64)
+    {
+        auto candidates = match_mask(first, needle.front()) & match_mask(first + size - 1, needle.back());
+        for (; candidates; candidates &= candidates - 1)
+        {
+            const auto candidate = first + trailing_zeroes(candidates);
+            if (std::memcmp(candidate, needle.data(), size) == 0)
+            {
+                return candidate;
+            }
+        }
+    }
+    const auto found = std::string_view(first, static_cast<size_t>(last - first)).find(needle);
+    return found == std::string_view::npos ? nullptr : first + found;
+}
+/// @}
+
+/// @brief Finds the line break that ends the record continuing at first
+/// @param inQuotes whether first is inside a quoted field, updated to the state at the returned position or at last
+/// @return The line break, or nullptr if the record does not end before last
+inline const char* find_record_end(const char* first,
+                                   const char* last,
+                                   bool& inQuotes,
+                                   char quoteChar = '"',
+                                   char lineBreak = '\n')
+{
+    while (true)
+    {
+        const auto newline = static_cast<const char*>(std::memchr(first, lineBreak, static_cast<size_t>(last - first)));
+        const auto lineEnd = newline ? newline : last;
+        for (auto quote = static_cast<const char*>(std::memchr(first, quoteChar, static_cast<size_t>(lineEnd - first)));
+             quote;
+             quote = static_cast<const char*>(std::memchr(quote + 1, quoteChar,
+                                                          static_cast<size_t>(lineEnd - quote - 1))))
+        {
+            inQuotes = !inQuotes;
+        }
+        if (!newline || !inQuotes)
+        {
+            return newline;
+        }
+        first = newline + 1;
+    }
+}
+
+/// @brief Reads whole records from a stream in large blocks
+/// A quoted field may contain line breaks, so a record ends at the first line break outside quotes.
+class RecordReader
+{
+public:
+    explicit RecordReader(std::istream& file, const read_options& options = {}, size_t blockSize = size_t(1) << 20)
+            : file(file), commentPrefix(options.commentPrefix), quote(options.quote), lineBreak(options.lineBreak),
+              buffer(std::max<size_t>(blockSize, 1)),
+              discarded(static_cast<uint64_t>(std::max<std::streamoff>(file.tellg(), 0)))
+    { }
+
+    /// @brief Byte offset in the stream of the next record
+    uint64_t offset() const
+    {
+        return discarded + begin;
+    }
+
+    /// @brief Blocks read from the stream so far
+    size_t blocks() const
+    {
+        return blocksRead;
+    }
+
+    /// @brief Whether offset() is inside a quoted field, which it is only if the reader started there
+    bool in_quotes() const
+    {
+        return inQuotes;
+    }
+
+    /// @brief Starts reading inside a quoted field, for a stream that was positioned inside one
+    void resume(bool quoted)
+    {
+        inQuotes = quoted;
+    }
+
+    /// @brief Gets the next record without its line ending; it stays valid until the next call
+    template<bool withStats = false>
+    bool next(std::string_view& record, Instrument<withStats>& instrument)
+    {
+        while (is_comment(instrument))
+        {
+            skip_lines(1, instrument);
+        }
+        while (true)
+        {
+            const auto data = buffer.data();
+            if (const auto recordEnd = find_record_end(data + scanned, data + end, inQuotes, quote, lineBreak))
+            {
+                record = take(static_cast<size_t>(recordEnd - data), 1);
+                instrument.lap(&parse_stats::tokenizeTime);
+                return true;
+            }
+            scanned = end;
+            if (eof)
+            {
+                if (begin == end)
+                {
+                    return false;
+                }
+                record = take(end, 0);
+                return true;
+            }
+            fill(instrument);
+        }
+    }
+
+    bool next(std::string_view& record)
+    {
+        Instrument<false> instrument;
+        return next(record, instrument);
+    }
+
+    /// @brief Gets the next record that contains needle, passing over the others without looking at their fields
+    template<bool withStats = false>
+    bool next_containing(std::string_view& record, std::string_view needle, Instrument<withStats>& instrument)
+    {
+        while (next(record, instrument))
+        {
+            const auto recordBegin = static_cast<size_t>(record.data() - buffer.data());
+            if (!matchValid || (match != std::string_view::npos && match < recordBegin))
+            {
+                // One search covers every record up to the next occurrence, until the buffer is refilled
+                const auto found = find_substring(record.data(), buffer.data() + end, needle);
+                match = found ? static_cast<size_t>(found - buffer.data()) : std::string_view::npos;
+                matchValid = true;
+                instrument.lap(&parse_stats::tokenizeTime);
+            }
+            if (match != std::string_view::npos && match + needle.size() <= recordBegin + record.size())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Makes the record last returned by next() the next one again
+    void unread()
+    {
+        begin = scanned = previousBegin;
+        inQuotes = false;
+    }
+
+    /// @brief Passes over lines by scanning for line breaks only, without looking at quotes or fields
+    template<bool withStats = false>
+    void skip_lines(size_t count, Instrument<withStats>& instrument)
+    {
+        while (count > 0 && (begin != end || !eof))
+        {
+            const auto data = buffer.data();
+            if (const auto newline = std::memchr(data + begin, lineBreak, end - begin))
+            {
+                begin = scanned = static_cast<size_t>(static_cast<const char*>(newline) - data) + 1;
+                --count;
+            }
+            else
+            {
+                begin = scanned = end; // nothing before the next block is needed
+                if (!fill(instrument) && --count == 0)
+                {
+                    break;
+                }
+            }
+        }
+        inQuotes = false;
+    }
+
+    void skip_lines(size_t count)
+    {
+        Instrument<false> instrument;
+        skip_lines(count, instrument);
+    }
+
+private:
+    template<bool withStats>
+    bool is_comment(Instrument<withStats>& instrument)
+    {
+        if (commentPrefix.empty())
+        {
+            return false;
+        }
+        while (end - begin < commentPrefix.size() && !eof)
+        {
+            fill(instrument);
+        }
+        return std::string_view(buffer.data() + begin, end - begin).substr(0, commentPrefix.size()) == commentPrefix;
+    }
+
+    /// @brief Takes [begin, recordEnd) as a record and skips the line break after it
+    std::string_view take(size_t recordEnd, size_t lineBreakSize)
+    {
+        std::string_view record(buffer.data() + begin, recordEnd - begin);
+        if (lineBreak == '\n' && !record.empty() && record.back() == '\r')
+        {
+            record.remove_suffix(1);
+        }
+        previousBegin = begin;
+        begin = scanned = recordEnd + lineBreakSize;
+        inQuotes = false;
+        return record;
+    }
+
+    /// @brief Reads more of the file
+    /// @return false once the end of the file is reached
+    template<bool withStats>
+    bool fill(Instrument<withStats>& instrument)
+    {
+        instrument.lap(&parse_stats::tokenizeTime);
+        instrument.bytes(refill());
+        instrument.lap(&parse_stats::ioTime);
+        return !eof;
+    }
+
+    /// @brief Moves the unfinished record to the front of the buffer and reads more after it
+    /// @return The number of bytes read
+    size_t refill()
+    {
+        matchValid = false;
+        discarded += begin;
+        std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+        end -= begin;
+        scanned -= begin;
+        begin = 0;
+        if (end == buffer.size())
+        {
+            buffer.resize(buffer.size() * 2); // a record longer than a block
+        }
+        file.read(buffer.data() + end, static_cast<std::streamsize>(buffer.size() - end));
+        const auto count = static_cast<size_t>(file.gcount());
+        end += count;
+        eof = count == 0;
+        blocksRead += !eof;
+        return count;
+    }
+
+    std::istream& file;
+    std::string commentPrefix;
+    char quote;
+    char lineBreak;
+    std::vector<char> buffer;
+    size_t begin = 0;         ///< start of the next record
+    size_t scanned = 0;       ///< how far the next record has been searched for its end
+    size_t end = 0;           ///< end of the data read
+    size_t previousBegin = 0; ///< start of the record last returned
+    size_t match = 0;         ///< where next_containing last found its needle
+    bool matchValid = false;  ///< whether match still refers to the buffer as it is
+    uint64_t discarded;       ///< bytes of the stream before the buffer
+    size_t blocksRead = 0;
+    bool inQuotes = false;
+    bool eof = false;
+};
+
+/// @brief Reports how far a load has got each time its reader reads a block, and checks then whether it is cancelled
+class ProgressMonitor
+{
+public:
+    ProgressMonitor(const read_options& options, uint64_t totalBytes)
+        : options(options), watching(options.onProgress || options.cancel),
+          start(std::chrono::steady_clock::now())
+    {
+        progress.totalBytes = totalBytes;
+    }
+
+    /// @return false once the load is cancelled
+    bool update(const RecordReader& reader, size_t rows)
+    {
+        if (!watching || reader.blocks() == blocks)
+        {
+            return true;
+        }
+        blocks = reader.blocks();
+        report(reader, rows);
+        return !(options.cancel && options.cancel->load(std::memory_order_relaxed));
+    }
+
+    void report(const RecordReader& reader, size_t rows)
+    {
+        if (options.onProgress)
+        {
+            progress.bytes = reader.offset();
+            progress.rows = rows;
+            progress.elapsed = std::chrono::steady_clock::now() - start;
+            options.onProgress(progress);
+        }
+    }
+
+private:
+    const read_options& options;
+    bool watching;
+    std::chrono::steady_clock::time_point start;
+    size_t blocks = 0;
+    load_progress progress;
+};
+
+/// @brief Where reading starts and how much of the file is read
+struct RowRange
+{
+    uint64_t offset = 0;  ///< byte offset of the first record to look at
+    size_t skip = 0;      ///< records to pass over from there
+    size_t maxRows = std::numeric_limits<size_t>::max();
+    bool indexed = false; ///< rows are records counted by an index, so the skipRows of the options do not apply
+};
+
+/// @brief Whether a record passes the filter of options, looking at no field after the filtered one
+template<typename Dialect>
+bool keep_record(std::string_view record, const Dialect& dialect, const read_options& options)
+{
+    RecordCursor row{record};
+    std::string_view field;
+    do
+    {
+        if (row.end)
+        {
+            return false; // too few fields
+        }
+        field = next_field(row, dialect);
+    } while (row.column <= options.filterColumn);
+    if (field.empty() || field.front() != dialect.quote)
+    {
+        return options.filter(field);
+    }
+    return options.filter(unquote(field, dialect.quote));
+}
+
+template<typename RowT, typename Dialect, bool withStats>
+auto parse_csv(RecordReader& reader,
+               const Dialect& dialect,
+               Instrument<withStats>& instrument,
+               size_t maxRows = std::numeric_limits<size_t>::max(),
+               const read_options& options = {},
+               uint64_t fileSize = 0)
+{
+    // An escaped quote does not appear as itself in the record, so such values are not searched for
+    auto needle = std::string_view(options.filterValue);
+    if (needle.find(options.quote) != needle.npos)
+    {
+        needle = {};
+    }
+    std::vector<decltype(parse_record<RowT>({}, dialect))> data;
+    if (options.expectedRows > 0)
+    {
+        data.reserve(std::min(options.expectedRows, maxRows));
+        instrument.allocations(true);
+    }
+    ProgressMonitor monitor(options, fileSize);
+    for (std::string_view record;
+         data.size() < maxRows
+         && (needle.empty() ? reader.next(record, instrument) : reader.next_containing(record, needle, instrument));)
+    {
+        if (!monitor.update(reader, data.size()))
+        {
+            return data;
+        }
+        if (options.filter)
+        {
+            const auto kept = keep_record(record, dialect, options);
+            instrument.lap(&parse_stats::tokenizeTime);
+            if (!kept)
+            {
+                continue;
+            }
+        }
+        const auto capacity = data.capacity();
+        data.emplace_back();
+        instrument.allocations(data.capacity() != capacity);
+        instrument.lap(&parse_stats::growthTime);
+        parse_record<RowT>(record, dialect, data.back(), instrument);
+    }
+    monitor.report(reader, data.size());
+    return data;
+}
+
+/// @brief Gets the delimiter from the next record if it is not given, leaving the record to be read
+template<bool withStats>
+char get_delimiter(RecordReader& reader, char delimiter, Instrument<withStats>& instrument)
+{
+    if (std::string_view record; delimiter == '\0' && reader.next(record, instrument))
+    {
+        delimiter = get_delimiter(record);
+        reader.unread();
+    }
+    instrument.lap(&parse_stats::sniffTime);
+    return delimiter == '\0' ? ',' : delimiter;
+}
+
+/// @brief Calls function with the compiled dialect for the delimiter and quote, if there is one
+template<typename Function>
+decltype(auto) with_dialect(char delimiter, const read_options& options, Function&& function)
+{
+    if (options.quote == '"')
+    {
+        switch (delimiter)
+        {
+        case ',':
+            return function(dialect<','>{});
+        case ';':
+            return function(dialect<';'>{});
+        case '\t':
+            return function(dialect<'\t'>{});
+        case ' ':
+            return function(dialect<' '>{});
+        case '|':
+            return function(dialect<'|'>{});
+        default:
+            break;
+        }
+    }
+    return function(RuntimeDialect{delimiter, options.quote, options.lineBreak});
+}
+
+/// @brief Reads the rows of a file into containers
+/// With a csv::dialect for DialectT, the file is parsed with it as given; its delimiter, quote and line break must
+/// be those of the options. Otherwise the compiled dialect for the delimiter of the options, or the detected one, is
+/// chosen by with_dialect().
+template<typename ContainerT, bool withStats = false, typename HeaderT = ignore, typename DialectT = RuntimeDialect>
+auto to_containers(std::string_view& path,
+                   const read_options& options,
+                   parse_stats* stats,
+                   RowRange range = {},
+                   HeaderT&& header = {},
+                   DialectT fixedDialect = {})
+{
+    using Data = decltype(parse_csv<ContainerT>(std::declval<RecordReader&>(), RuntimeDialect{},
+                                                std::declval<Instrument<withStats>&>()));
+    if constexpr (!withStats)
+    {
+        if (stats)
+        {
+            return to_containers<ContainerT, true>(path, options, stats, range, std::forward<HeaderT>(header),
+                                                   fixedDialect);
+        }
+    }
+    else
+    {
+        *stats = {};
+    }
+    Instrument<withStats> instrument(stats);
+
+    // Open file
+    auto file = std::ifstream(path.data(), std::ios::binary);
+    if (!file)
+    {
+        return Data{};
+    }
+    file.seekg(static_cast<std::streamoff>(range.offset));
+    RecordReader reader(file, options);
+    if (!range.indexed)
+    {
+        reader.skip_lines(options.skipRows, instrument);
+    }
+    // Check delimiter
+    const auto delimiter = detail::get_delimiter(reader, options.delimiter, instrument);
+    for (std::string_view record; range.skip > 0 && reader.next(record, instrument); --range.skip)
+    {
+    }
+    const auto parse = [&](const auto& dialect)
+    {
+        // Read header
+        if constexpr (!std::is_same_v<HeaderT, ignore>)
+        {
+            if (std::string_view record; reader.next(record, instrument))
+            {
+                header = detail::parse_record<std::decay_t<HeaderT>>(record, dialect);
+            }
+        }
+        // Read CSV
+        std::error_code error;
+        const auto fileSize = options.onProgress ? std::filesystem::file_size(std::string(path), error) : 0;
+        return detail::parse_csv<ContainerT>(reader, dialect, instrument, std::min(range.maxRows, options.maxRows),
+                                             options, error ? 0 : fileSize);
+    };
+    Data data;
+    if constexpr (IsRuntimeDialect<DialectT>::value)
+    {
+        data = with_dialect(delimiter, options, parse);
+    }
+    else
+    {
+        data = parse(fixedDialect);
+    }
+    if constexpr (withStats)
+    {
+        stats->rows = data.size();
+    }
+    return data;
+}
+} // namespace detail
+
+template<typename T, typename Predicate>
+read_options& read_options::where(size_t column, Predicate predicate)
+{
+    return where(column, [predicate = std::move(predicate)](std::string_view field)
+    {
+        T value{};
+        return detail::parse_value(detail::strip_quotes(field), value) && predicate(value);
+    });
+}
+
+std::vector<std::string> get_header(std::string_view path, const read_options& options = {})
+{
+    // Open file
+    if (auto file = std::ifstream(path.data(), std::ios::binary))
+    {
+        detail::RecordReader reader(file, options, 1 << 12);
+        reader.skip_lines(options.skipRows);
+        // Read header
+        if (std::string_view record; reader.next(record))
+        {
+            const auto delimiter = options.delimiter == '\0' ? detail::get_delimiter(record) : options.delimiter;
+            return detail::parse_record<std::vector<std::string>>(record,
+                                                                  detail::RuntimeDialect{delimiter, options.quote});
+        }
+    }
+    return {};
+}
+
+template<typename ValueT, size_t nColumns>
+std::vector<std::array<ValueT, nColumns>> to_arrays(std::string_view path,
+                                                    const read_options& options = {},
+                                                    parse_stats* stats = nullptr)
+{
+    return detail::to_containers<std::array<ValueT, nColumns>>(path, options, stats);
+}
+
+template<typename ValueT, size_t nColumns>
+std::vector<std::array<ValueT, nColumns>> to_arrays(std::string_view path,
+                                                    std::array<std::string, nColumns>& header,
+                                                    const read_options& options = {},
+                                                    parse_stats* stats = nullptr)
+{
+    return detail::to_containers<std::array<ValueT, nColumns>>(path, options, stats, {}, header);
+}
+
+/// @brief Reads a file with a dialect compiled in as given, whose delimiter, quote and line break replace those of
+/// the options
+template<typename ValueT, size_t nColumns, char Delimiter, char Quote, char LineBreak>
+std::vector<std::array<ValueT, nColumns>> to_arrays(std::string_view path,
+                                                    dialect<Delimiter, Quote, LineBreak> fixedDialect,
+                                                    const read_options& options = {},
+                                                    parse_stats* stats = nullptr)
+{
+    return detail::to_containers<std::array<ValueT, nColumns>>(
+            path, detail::with_fixed_dialect(options, fixedDialect), stats, {}, ignore{}, fixedDialect);
+}
+
+template<typename ValueT, size_t nColumns, char Delimiter, char Quote, char LineBreak>
+std::vector<std::array<ValueT, nColumns>> to_arrays(std::string_view path,
+                                                    std::array<std::string, nColumns>& header,
+                                                    dialect<Delimiter, Quote, LineBreak> fixedDialect,
+                                                    const read_options& options = {},
+                                                    parse_stats* stats = nullptr)
+{
+    return detail::to_containers<std::array<ValueT, nColumns>>(
+            path, detail::with_fixed_dialect(options, fixedDialect), stats, {}, header, fixedDialect);
+}
+
+template<typename... ColumnTs>
+std::vector<FilteredTuple<ColumnTs...>> to_tuples(std::string_view path,
+                                                  const read_options& options = {},
+                                                  parse_stats* stats = nullptr)
+{
+    return detail::to_containers<std::tuple<ColumnTs...>>(path, options, stats);
+}
+
+template<typename... ColumnTs, size_t nColumns = std::tuple_size_v<FilteredTuple<ColumnTs...>>>
+std::vector<FilteredTuple<ColumnTs...>> to_tuples(std::string_view path,
+                                                  std::array<std::string, nColumns>& header,
+                                                  const read_options& options = {},
+                                                  parse_stats* stats = nullptr)
+{
+    return detail::to_containers<std::tuple<ColumnTs...>>(path, options, stats, {}, header);
+}
+
+/// @brief Reads a file with a dialect compiled in as given, whose delimiter, quote and line break replace those of
+/// the options
+template<typename... ColumnTs, char Delimiter, char Quote, char LineBreak>
+std::vector<FilteredTuple<ColumnTs...>> to_tuples(std::string_view path,
+                                                  dialect<Delimiter, Quote, LineBreak> fixedDialect,
+                                                  const read_options& options = {},
+                                                  parse_stats* stats = nullptr)
+{
+    return detail::to_containers<std::tuple<ColumnTs...>>(
+            path, detail::with_fixed_dialect(options, fixedDialect), stats, {}, ignore{}, fixedDialect);
+}
+
+template<typename... ColumnTs, char Delimiter, char Quote, char LineBreak,
+         size_t nColumns = std::tuple_size_v<FilteredTuple<ColumnTs...>>>
+std::vector<FilteredTuple<ColumnTs...>> to_tuples(std::string_view path,
+                                                  std::array<std::string, nColumns>& header,
+                                                  dialect<Delimiter, Quote, LineBreak> fixedDialect,
+                                                  const read_options& options = {},
+                                                  parse_stats* stats = nullptr)
+{
+    return detail::to_containers<std::tuple<ColumnTs...>>(
+            path, detail::with_fixed_dialect(options, fixedDialect), stats, {}, header, fixedDialect);
+}
+
+template<typename ValueT>
+std::vector<std::vector<ValueT>> to_vectors(std::string_view path,
+                                            const read_options& options = {},
+                                            parse_stats* stats = nullptr)
+{
+    return detail::to_containers<std::vector<ValueT>>(path, options, stats);
+}
+
+template<typename ValueT>
+std::vector<std::vector<ValueT>> to_vectors(std::string_view path,
+                                            std::vector<std::string>& header,
+                                            const read_options& options = {},
+                                            parse_stats* stats = nullptr)
+{
+    return detail::to_containers<std::vector<ValueT>>(path, options, stats, {}, header);
+}
+
+/// @brief Reads a file with a dialect compiled in as given, whose delimiter, quote and line break replace those of
+/// the options
+template<typename ValueT, char Delimiter, char Quote, char LineBreak>
+std::vector<std::vector<ValueT>> to_vectors(std::string_view path,
+                                            dialect<Delimiter, Quote, LineBreak> fixedDialect,
+                                            const read_options& options = {},
+                                            parse_stats* stats = nullptr)
+{
+    return detail::to_containers<std::vector<ValueT>>(
+            path, detail::with_fixed_dialect(options, fixedDialect), stats, {}, ignore{}, fixedDialect);
+}
+
+template<typename ValueT, char Delimiter, char Quote, char LineBreak>
+std::vector<std::vector<ValueT>> to_vectors(std::string_view path,
+                                            std::vector<std::string>& header,
+                                            dialect<Delimiter, Quote, LineBreak> fixedDialect,
+                                            const read_options& options = {},
+                                            parse_stats* stats = nullptr)
+{
+    return detail::to_containers<std::vector<ValueT>>(
+            path, detail::with_fixed_dialect(options, fixedDialect), stats, {}, header, fixedDialect);
+}
+
+/// @brief Quoting policy for written string fields
+enum class quoting
+{
+    minimal, ///< quote fields containing the delimiter, a quote or a line break
+    all,     ///< quote every string field
+    none     ///< never quote
+};
+
+struct write_options
+{
+    char delimiter = ',';
+    quoting quote = quoting::minimal;
+    size_t threads = 1;          ///< formatting threads, 0 for one per hardware thread
+    size_t bufferSize = 1 << 20; ///< bytes formatted before each write to the file
+};
+
+namespace detail
+{
+
+inline size_t thread_count(size_t requested)
+{
+    return requested != 0 ? requested : std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+/// @brief Calls function(i) for every i in [0, count), spread over up to nThreads threads
+template<typename Function>
+void parallel_for(size_t count, size_t nThreads, Function&& function)
+{
+    std::atomic<size_t> next{0};
+    const auto work = [&]
+    {
+        for (auto i = next++; i < count; i = next++)
+        {
+            function(i);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < std::min(count, nThreads); ++t)
+    {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+/// @brief Writes the shortest representation of value that parses back to the same bits
+/// @return One past the last character written
+template<typename T>
+char* format_shortest(char* first, char* last, T value)
+{
+#if defined(__cpp_lib_to_chars)
+    return std::to_chars(first, last, value).ptr;
+#else
+    // No floating-point std::to_chars: try increasing precision until the text round-trips
+    const auto size = static_cast<size_t>(last - first);
+    for (int precision = 1; precision < std::numeric_limits<T>::max_digits10; ++precision)
+    {
+        std::snprintf(first, size, "%.*Lg", precision, static_cast<long double>(value));
+        T parsed;
+        if constexpr (std::is_same_v<T, float>) parsed = std::strtof(first, nullptr);
+        else if constexpr (std::is_same_v<T, double>) parsed = std::strtod(first, nullptr);
+        else parsed = std::strtold(first, nullptr);
+        if (parsed == value)
+        {
+            return first + std::strlen(first);
+        }
+    }
+    std::snprintf(first, size, "%.*Lg", std::numeric_limits<T>::max_digits10, static_cast<long double>(value));
+    return first + std::strlen(first);
+#endif
+}
+
+template<typename T>
+void format_value(std::string& out, const T& value, const write_options& options)
+{
+    if constexpr (std::is_same_v<T, bool>)
+    {
+        out += value ? "true" : "false";
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        char buffer[64];
+        out.append(buffer, format_shortest(std::begin(buffer), std::end(buffer), value));
+    }
+    else if constexpr (std::is_integral_v<T> && sizeof(T) > 1)
+    {
+        char buffer[24];
+        const auto result = std::to_chars(std::begin(buffer), std::end(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+    else
+    {
+        // Character types write a single character, as they are read
+        std::string_view field;
+        if constexpr (std::is_integral_v<T>)
+        {
+            field = std::string_view(reinterpret_cast<const char*>(&value), 1);
+        }
+        else
+        {
+            field = value;
+        }
+        const char special[] = {options.delimiter, '"', '\n', '\r'};
+        const bool quoted = options.quote == quoting::all
+                            || (options.quote == quoting::minimal
+                                && field.find_first_of(std::string_view(special, sizeof(special))) != field.npos);
+        if (!quoted)
+        {
+            out += field;
+            return;
+        }
+        out += '"';
+        for (const auto c : field)
+        {
+            if (c == '"')
+            {
+                out += '"';
+            }
+            out += c;
+        }
+        out += '"';
+    }
+}
+
+template<typename RowT>
+void format_row(std::string& out, const RowT& row, const write_options& options)
+{
+    if constexpr (IsTuple<RowT>::value)
+    {
+        std::apply([&](const auto&... values)
+                   {
+                       size_t column = 0;
+                       ((column++ == 0 ? void() : void(out += options.delimiter), format_value(out, values, options)), ...);
+                   }, row);
+    }
+    else
+    {
+        bool first = true;
+        for (const auto& value : row)
+        {
+            if (!std::exchange(first, false))
+            {
+                out += options.delimiter;
+            }
+            format_value(out, value, options);
+        }
+    }
+    out += '\n';
+}
+
+template<typename RowT>
+void write_rows(std::ofstream& file, const std::vector<RowT>& rows, const write_options& options)
+{
+    const auto nThreads = thread_count(options.threads);
+    if (nThreads == 1)
+    {
+        std::string buffer;
+        buffer.reserve(options.bufferSize);
+        for (const auto& row : rows)
+        {
+            format_row(buffer, row, options);
+            if (buffer.size() >= options.bufferSize)
+            {
+                file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                buffer.clear();
+            }
+        }
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        return;
+    }
+
+    // Thread t formats chunks t, t + nThreads, ... into its own buffer, and writes each one when its turn comes
+    constexpr size_t rowsPerChunk = 1 << 14;
+    const auto nChunks = (rows.size() + rowsPerChunk - 1) / rowsPerChunk;
+    std::mutex mutex;
+    std::condition_variable written;
+    size_t nextChunk = 0;
+    parallel_for(nThreads, nThreads, [&](size_t thread)
+    {
+        std::string buffer;
+        for (auto chunk = thread; chunk < nChunks; chunk += nThreads)
+        {
+            buffer.clear();
+            const auto first = chunk * rowsPerChunk;
+            const auto last = std::min(rows.size(), first + rowsPerChunk);
+            for (auto i = first; i < last; ++i)
+            {
+                format_row(buffer, rows[i], options);
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            written.wait(lock, [&] { return nextChunk == chunk; });
+            lock.unlock();
+            file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            lock.lock();
+            ++nextChunk;
+            written.notify_all();
+        }
+    });
+}
+} // namespace detail
+
+template<typename RowT>
+bool write(std::string_view path, const std::vector<RowT>& rows, const write_options& options = {})
+{
+    auto file = std::ofstream(std::string(path), std::ios::binary);
+    if (file)
+    {
+        detail::write_rows(file, rows, options);
+    }
+    return static_cast<bool>(file);
+}
+
+template<typename RowT, typename HeaderT>
+bool write(std::string_view path,
+           const std::vector<RowT>& rows,
+           const HeaderT& header,
+           const write_options& options = {})
+{
+    auto file = std::ofstream(std::string(path), std::ios::binary);
+    if (file)
+    {
+        std::string line;
+        detail::format_row(line, header, options);
+        file.write(line.data(), static_cast<std::streamsize>(line.size()));
+        detail::write_rows(file, rows, options);
+    }
+    return static_cast<bool>(file);
+}
+
+namespace detail
+{
+
+/// @defgroup Line break scanning
+/// The input is examined 64 bytes at a time as bit masks of line breaks and quotes. Whether a position is inside a
+/// quoted field is the running parity of the quotes before it, which is a prefix XOR over the quote mask.
+/// @{
+/// @brief Bit i is the XOR of bits 0..i
+inline uint64_t prefix_xor(uint64_t bits)
+{
+    for (int shift = 1; shift < 64; shift *= 2)
+    {
+        bits ^= bits << shift;
+    }
+    return bits;
+}
+
+/// @brief Calls function(block, size) for each 64-byte block of [first, last); the last block is zero-padded
+template<typename Function>
+void for_each_block(const char* first, const char* last, Function&& function)
+{
+    for (; last - first >= 64; first += 64)
+    {
+        function(first, size_t(64));
+    }
+    if (first != last)
+    {
+        char padded[64] = {}; // zeros match neither line breaks nor quotes
+        std::memcpy(padded, first, static_cast<size_t>(last - first));
+        function(static_cast<const char*>(padded), static_cast<size_t>(last - first));
+    }
+}
+
+/// @brief Bit i is set where block[i] is inside a quoted field
+/// @param inQuotes whether the block starts inside a quoted field, updated to the state after it
+inline uint64_t quoted_mask(const char* block, bool& inQuotes)
+{
+    const auto inside = prefix_xor(match_mask(block, '"')) ^ (inQuotes ? ~uint64_t(0) : 0);
+    inQuotes = inside >> 63;
+    return inside;
+}
+
+struct LineCounts
+{
+    size_t lineBreaks = 0;        ///< all line breaks
+    size_t lineBreaksOutside = 0; ///< line breaks outside quotes, for a range that starts outside quotes
+    bool oddQuotes = false;       ///< whether the range has an odd number of quotes, flipping the state after it
+
+    /// @brief Records ended within the range, given the quote state at its start
+    size_t record_ends(bool startsInQuotes) const
+    {
+        return startsInQuotes ? lineBreaks - lineBreaksOutside : lineBreaksOutside;
+    }
+};
+
+inline LineCounts count_lines(const char* first, const char* last, bool quoteAware)
+{
+    LineCounts counts;
+    for_each_block(first, last, [&](const char* block, size_t)
+    {
+        const auto lineBreaks = match_mask(block, '\n');
+        counts.lineBreaks += static_cast<size_t>(count_bits(lineBreaks));
+        if (quoteAware)
+        {
+            const auto outside = lineBreaks & ~quoted_mask(block, counts.oddQuotes);
+            counts.lineBreaksOutside += static_cast<size_t>(count_bits(outside));
+        }
+    });
+    if (!quoteAware)
+    {
+        counts.lineBreaksOutside = counts.lineBreaks;
+    }
+    return counts;
+}
+
+/// @brief The records of text counted in chunks on several threads, with where each chunk starts in records and
+/// quote state
+struct RecordCounts
+{
+    std::vector<std::string_view> chunks;
+    std::vector<size_t> endsBefore;    ///< record ends before each chunk, and in all of text at the back
+    std::vector<char> startsInQuotes;  ///< whether each chunk starts inside a quoted field
+    size_t records = 0;                ///< including a last record without a line break
+
+    /// @brief Counts the line breaks of each chunk in parallel, then chains the quote states from the first chunk
+    RecordCounts(std::string_view text, size_t nThreads, bool quoteAware)
+    {
+        const auto nChunks = std::max<size_t>(1, std::min(nThreads * 4, text.size() / (1 << 16)));
+        const auto chunkSize = (text.size() + nChunks - 1) / nChunks;
+        for (size_t i = 0; i < nChunks; ++i)
+        {
+            const auto first = std::min(text.size(), i * chunkSize);
+            chunks.push_back(text.substr(first, std::min(chunkSize, text.size() - first)));
+        }
+        std::vector<LineCounts> counts(nChunks);
+        parallel_for(nChunks, nThreads, [&](size_t i)
+        {
+            counts[i] = count_lines(chunks[i].data(), chunks[i].data() + chunks[i].size(), quoteAware);
+        });
+        endsBefore.resize(nChunks + 1);
+        startsInQuotes.resize(nChunks + 1);
+        for (size_t i = 0; i < nChunks; ++i)
+        {
+            endsBefore[i + 1] = endsBefore[i] + counts[i].record_ends(startsInQuotes[i]);
+            startsInQuotes[i + 1] = static_cast<char>(startsInQuotes[i] != counts[i].oddQuotes);
+        }
+        records = endsBefore.back() + (!text.empty() && text.back() != '\n');
+    }
+};
+
+/// @brief Calls function(offset) with the offset from first of every line break that ends a record
+/// @param inQuotes whether first is inside a quoted field, updated to the state at last
+template<typename Function>
+void for_each_record_end(const char* first, const char* last, bool& inQuotes, bool quoteAware, Function&& function)
+{
+    size_t offset = 0;
+    for_each_block(first, last, [&](const char* block, size_t size)
+    {
+        auto lineBreaks = match_mask(block, '\n');
+        if (quoteAware)
+        {
+            lineBreaks &= ~quoted_mask(block, inQuotes);
+        }
+        for (; lineBreaks; lineBreaks &= lineBreaks - 1)
+        {
+            function(offset + static_cast<size_t>(trailing_zeroes(lineBreaks)));
+        }
+        offset += size;
+    });
+}
+/// @}
+
+/// @brief A read-only view of a whole file, memory-mapped where the platform supports it
+class MappedFile
+{
+public:
+    explicit MappedFile(std::string_view path)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        const auto descriptor = ::open(std::string(path).c_str(), O_RDONLY);
+        if (descriptor < 0)
+        {
+            return;
+        }
+        struct stat status{};
+        if (::fstat(descriptor, &status) == 0)
+        {
+            size = static_cast<size_t>(status.st_size);
+            opened = true;
+            if (size > 0)
+            {
+                address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+                if (address == MAP_FAILED)
+                {
+                    address = nullptr;
+                    opened = false;
+                }
+            }
+        }
+        ::close(descriptor);
+#else
+        auto file = std::ifstream(std::string(path), std::ios::binary);
+        opened = static_cast<bool>(file);
+        contents.assign(std::istreambuf_iterator<char>(file), {});
+#endif
+    }
+
+    ~MappedFile()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if (address)
+        {
+            ::munmap(address, size);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    explicit operator bool() const
+    {
+        return opened;
+    }
+
+    std::string_view view() const
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        return {static_cast<const char*>(address), size};
+#else
+        return {contents.data(), contents.size()};
+#endif
+    }
+
+private:
+    bool opened = false;
+#if defined(__unix__) || defined(__APPLE__)
+    void* address = nullptr;
+    size_t size = 0;
+#else
+    std::vector<char> contents;
+#endif
+};
+} // namespace detail
+
+/// @brief Counts the records of a file, including any header, without parsing them
+/// The memory-mapped file is scanned 64 bytes at a time for line breaks on several threads, each counting a chunk
+/// both as if it started inside and outside quotes; the chunks' quote states are then chained from the start.
+/// @param threads scanning threads, 0 for one per hardware thread
+/// @param quoteAware whether line breaks inside quoted fields are part of a record; turn off for files that have no
+/// quoted line breaks to skip tracking quotes
+/// @return 0 if the file could not be read
+inline size_t count_rows(std::string_view path, size_t threads = 0, bool quoteAware = true)
+{
+    const detail::MappedFile file(path);
+    return file ? detail::RecordCounts(file.view(), detail::thread_count(threads), quoteAware).records : 0;
+}
+
+/// @brief Byte offsets of every stride-th record of a CSV file, so a range of rows can be read without parsing the
+/// rows before it
+/// Rows are counted from the start of the file, so with a header the first data row is row 1. Reads through an index
+/// take rows by these numbers, so the skipRows of their options are not applied.
+class index
+{
+public:
+    index() = default;
+
+    /// @brief Scans the file on several threads, recording where every stride-th record starts
+    /// @param threads scanning threads, 0 for one per hardware thread
+    /// @param quoteAware whether line breaks inside quoted fields are part of a record; turn off for files that
+    /// have no quoted line breaks to skip tracking quotes
+    static index build(std::string_view path, size_t stride = 1024, size_t threads = 0, bool quoteAware = true)
+    {
+        const detail::MappedFile file(path);
+        if (!file)
+        {
+            return {};
+        }
+        const auto text = file.view();
+        index result;
+        result.rowStride = std::max<size_t>(stride, 1);
+        result.fileSize = text.size();
+
+        // Count the record ends in each chunk, then derive where each chunk starts in rows and quote state
+        const auto nThreads = detail::thread_count(threads);
+        const detail::RecordCounts counts(text, nThreads, quoteAware);
+        result.nRows = counts.records;
+
+        // Record the start of every stride-th record
+        result.offsets.resize((result.nRows + result.rowStride - 1) / result.rowStride);
+        detail::parallel_for(counts.chunks.size(), nThreads, [&](size_t i)
+        {
+            const auto range = counts.chunks[i];
+            const auto rangeOffset = static_cast<uint64_t>(range.data() - text.data());
+            auto row = counts.endsBefore[i]; // records ended so far, which is the number of the next record
+            bool inQuotes = counts.startsInQuotes[i];
+            detail::for_each_record_end(range.data(), range.data() + range.size(), inQuotes, quoteAware,
+                                        [&](size_t offset)
+                                        {
+                                            if (++row % result.rowStride == 0 && row < result.nRows)
+                                            {
+                                                result.offsets[row / result.rowStride] = rangeOffset + offset + 1;
+                                            }
+                                        });
+        });
+        return result;
+    }
+
+    /// @brief Where the index of path is kept
+    static std::string sidecar_path(std::string_view path)
+    {
+        return std::string(path) + ".idx";
+    }
+
+    /// @brief Writes the index next to the CSV file it was built from
+    bool save(std::string_view path) const
+    {
+        auto file = std::ofstream(sidecar_path(path), std::ios::binary);
+        const uint64_t fields[] = {version, rowStride, nRows, fileSize, offsets.size()};
+        file.write(magic, sizeof(magic));
+        file.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+        file.write(reinterpret_cast<const char*>(offsets.data()),
+                   static_cast<std::streamsize>(offsets.size() * sizeof(uint64_t)));
+        return static_cast<bool>(file);
+    }
+
+    /// @brief Reads the index kept next to path
+    /// @return An empty index if there is none, or the CSV file has changed size since it was built
+    static index load(std::string_view path)
+    {
+        auto file = std::ifstream(sidecar_path(path), std::ios::binary);
+        char fileMagic[sizeof(magic)] = {};
+        uint64_t fields[5] = {};
+        file.read(fileMagic, sizeof(fileMagic));
+        file.read(reinterpret_cast<char*>(fields), sizeof(fields));
+        std::error_code error;
+        if (!file || std::memcmp(fileMagic, magic, sizeof(magic)) != 0 || fields[0] != version
+            || fields[3] != std::filesystem::file_size(std::filesystem::path(std::string(path)), error))
+        {
+            return {};
+        }
+        index result;
+        result.rowStride = fields[1];
+        result.nRows = fields[2];
+        result.fileSize = fields[3];
+        result.offsets.resize(fields[4]);
+        file.read(reinterpret_cast<char*>(result.offsets.data()),
+                  static_cast<std::streamsize>(result.offsets.size() * sizeof(uint64_t)));
+        return file ? result : index{};
+    }
+
+    bool empty() const
+    {
+        return offsets.empty();
+    }
+
+    /// @brief Number of records in the file, including any header
+    size_t rows() const
+    {
+        return nRows;
+    }
+
+    size_t stride() const
+    {
+        return rowStride;
+    }
+
+    /// @brief Byte offset of the closest indexed record at or before row
+    uint64_t offset(size_t row) const
+    {
+        return offsets.empty() ? 0 : offsets[std::min(row / rowStride, offsets.size() - 1)];
+    }
+
+    /// @brief The row whose offset is returned by offset(row)
+    size_t indexed_row(size_t row) const
+    {
+        return offsets.empty() ? 0 : std::min(row / rowStride, offsets.size() - 1) * rowStride;
+    }
+
+private:
+    static constexpr char magic[8] = {'S', 'T', 'D', 'C', 'S', 'V', 'I', 'X'};
+    static constexpr uint64_t version = 1;
+
+    uint64_t rowStride = 1;
+    uint64_t nRows = 0;
+    uint64_t fileSize = 0;
+    std::vector<uint64_t> offsets; ///< offsets[i] is where record i * rowStride starts
+};
+
+namespace detail
+{
+
+inline RowRange row_range(const index& rowIndex, size_t firstRow, size_t nRows)
+{
+    return {rowIndex.offset(firstRow), firstRow - rowIndex.indexed_row(firstRow), nRows, true};
+}
+} // namespace detail
+
+/// @brief Reads rows [firstRow, firstRow + nRows), seeking with rowIndex instead of parsing the rows before them
+template<typename ValueT, size_t nColumns>
+std::vector<std::array<ValueT, nColumns>> to_arrays(std::string_view path,
+                                                    const index& rowIndex,
+                                                    size_t firstRow,
+                                                    size_t nRows,
+                                                    const read_options& options = {},
+                                                    parse_stats* stats = nullptr)
+{
+    return detail::to_containers<std::array<ValueT, nColumns>>(path, options, stats,
+                                                               detail::row_range(rowIndex, firstRow, nRows));
+}
+
+/// @brief Reads rows [firstRow, firstRow + nRows), seeking with rowIndex instead of parsing the rows before them
+/// Rows are the records of the file as rowIndex counts them; options.skipRows is not applied.
+template<typename... ColumnTs>
+std::vector<FilteredTuple<ColumnTs...>> to_tuples(std::string_view path,
+                                                  const index& rowIndex,
+                                                  size_t firstRow,
+                                                  size_t nRows,
+                                                  const read_options& options = {},
+                                                  parse_stats* stats = nullptr)
+{
+    return detail::to_containers<std::tuple<ColumnTs...>>(path, options, stats,
+                                                          detail::row_range(rowIndex, firstRow, nRows));
+}
+
+/// @brief Reads rows [firstRow, firstRow + nRows), seeking with rowIndex instead of parsing the rows before them
+template<typename ValueT>
+std::vector<std::vector<ValueT>> to_vectors(std::string_view path,
+                                            const index& rowIndex,
+                                            size_t firstRow,
+                                            size_t nRows,
+                                            const read_options& options = {},
+                                            parse_stats* stats = nullptr)
+{
+    return detail::to_containers<std::vector<ValueT>>(path, options, stats,
+                                                      detail::row_range(rowIndex, firstRow, nRows));
+}
+
+/// @brief Reads the rows appended to a growing CSV file, each of them once
+/// The file is read from where the last complete record ended, so a poll costs as much as the new data. A record that
+/// is still being written is kept until its line break arrives. A file that shrinks is read again from the start.
+template<typename RowT>
+class follower
+{
+public:
+    using row_type = decltype(detail::parse_record<RowT>({}, ','));
+
+    explicit follower(std::string path, const read_options& options = {}, bool withHeader = false)
+            : path(std::move(path)), options(options), withHeader(withHeader)
+    {
+        reset();
+#if defined(__linux__)
+        notifier = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        watch_file();
+#endif
+    }
+
+    ~follower()
+    {
+#if defined(__linux__)
+        if (notifier >= 0)
+        {
+            ::close(notifier);
+        }
+#endif
+    }
+
+    follower(const follower&) = delete;
+    follower& operator=(const follower&) = delete;
+
+    /// @brief The complete rows appended since the last call
+    std::vector<row_type> poll()
+    {
+        read_appended();
+        std::vector<row_type> rows;
+        const auto data = pending.data();
+        size_t position = 0;
+        while (position < pending.size())
+        {
+            const auto remaining = std::string_view(data + position, pending.size() - position);
+            const auto lineEnd = remaining.find(options.lineBreak);
+            if (linesToSkip > 0 || is_comment(remaining))
+            {
+                if (lineEnd == remaining.npos)
+                {
+                    break;
+                }
+                linesToSkip -= linesToSkip > 0;
+                position += lineEnd + 1;
+                continue;
+            }
+            if (remaining.size() < options.commentPrefix.size() && lineEnd == remaining.npos)
+            {
+                break; // could still turn out to be a comment
+            }
+            bool inQuotes = false;
+            const auto recordEnd = detail::find_record_end(remaining.data(), remaining.data() + remaining.size(),
+                                                           inQuotes, options.quote, options.lineBreak);
+            if (!recordEnd)
+            {
+                break;
+            }
+            auto record = remaining.substr(0, static_cast<size_t>(recordEnd - remaining.data()));
+            position += record.size() + 1;
+            if (options.lineBreak == '\n' && !record.empty() && record.back() == '\r')
+            {
+                record.remove_suffix(1);
+            }
+            take(record, rows);
+        }
+        pending.erase(0, position);
+        consumed += position;
+        return rows;
+    }
+
+    /// @brief Waits up to timeout for the file to change, then gets the complete rows appended since the last call
+    std::vector<row_type> wait(std::chrono::milliseconds timeout)
+    {
+        if (auto rows = poll(); !rows.empty())
+        {
+            return rows;
+        }
+#if defined(__linux__)
+        if (watch_file())
+        {
+            pollfd descriptor{notifier, POLLIN, 0};
+            if (::poll(&descriptor, 1, static_cast<int>(timeout.count())) > 0)
+            {
+                alignas(inotify_event) char events[4096];
+                bool replaced = false;
+                for (ssize_t size; (size = ::read(notifier, events, sizeof(events))) > 0;)
+                {
+                    for (ssize_t i = 0; i < size;)
+                    {
+                        const auto event = reinterpret_cast<const inotify_event*>(events + i);
+                        replaced |= (event->mask & (IN_MOVE_SELF | IN_DELETE_SELF | IN_IGNORED)) != 0;
+                        i += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                    }
+                }
+                if (replaced)
+                {
+                    // Rotated: the path now names another file, if any
+                    reset();
+                    ::inotify_rm_watch(notifier, watched);
+                    watched = -1;
+                    watch_file();
+                }
+            }
+            return poll();
+        }
+#endif
+        // Without change notifications the file size is checked every few milliseconds
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        const auto size = file_size();
+        while (file_size() == size && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+                    std::chrono::milliseconds(10), deadline - std::chrono::steady_clock::now()));
+        }
+        return poll();
+    }
+
+    /// @brief Byte offset just after the last complete record read
+    uint64_t offset() const
+    {
+        return consumed;
+    }
+
+    /// @brief The header, once its record is complete, if the follower was made withHeader
+    const std::vector<std::string>& header() const
+    {
+        return headerRow;
+    }
+
+private:
+    void reset()
+    {
+        consumed = 0;
+        pending.clear();
+        linesToSkip = options.skipRows;
+        rowsTaken = 0;
+        dialect = {options.delimiter, options.quote, options.lineBreak};
+        headerRow.clear();
+        headerRead = !withHeader;
+    }
+
+    bool is_comment(std::string_view remaining) const
+    {
+        const auto& prefix = options.commentPrefix;
+        return !prefix.empty() && remaining.substr(0, prefix.size()) == prefix;
+    }
+
+    uint64_t file_size() const
+    {
+        std::error_code error;
+        const auto size = std::filesystem::file_size(path, error);
+        return error ? 0 : size;
+    }
+
+    /// @brief Appends what was written after the data already read to pending
+    void read_appended()
+    {
+        auto file = std::ifstream(path, std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            return;
+        }
+        const auto size = static_cast<uint64_t>(file.tellg());
+        auto readOffset = consumed + pending.size();
+        if (size < readOffset)
+        {
+            reset(); // truncated
+            readOffset = 0;
+        }
+        if (size == readOffset)
+        {
+            return;
+        }
+        file.seekg(static_cast<std::streamoff>(readOffset));
+        const auto previous = pending.size();
+        pending.resize(previous + static_cast<size_t>(size - readOffset));
+        file.read(pending.data() + previous, static_cast<std::streamsize>(size - readOffset));
+        pending.resize(previous + static_cast<size_t>(file.gcount()));
+    }
+
+    void take(std::string_view record, std::vector<row_type>& rows)
+    {
+        if (dialect.delimiter == '\0')
+        {
+            dialect.delimiter = detail::get_delimiter(record);
+        }
+        if (!headerRead)
+        {
+            headerRow = detail::parse_record<std::vector<std::string>>(record, dialect);
+            headerRead = true;
+        }
+        else if (rowsTaken < options.maxRows && (!options.filter || detail::keep_record(record, dialect, options)))
+        {
+            rows.push_back(detail::parse_record<RowT>(record, dialect));
+            ++rowsTaken;
+        }
+    }
+
+#if defined(__linux__)
+    /// @brief Watches the file at path if it is not watched yet; it may not exist yet
+    bool watch_file()
+    {
+        if (notifier >= 0 && watched < 0)
+        {
+            watched = ::inotify_add_watch(notifier, path.c_str(),
+                                          IN_MODIFY | IN_CLOSE_WRITE | IN_MOVE_SELF | IN_DELETE_SELF);
+        }
+        return watched >= 0;
+    }
+
+    int notifier = -1;
+    int watched = -1;
+#endif
+    std::string path;
+    read_options options;
+    bool withHeader;
+    uint64_t consumed = 0; ///< byte offset of the start of pending
+    std::string pending;   ///< data read after the last complete record
+    size_t linesToSkip = 0;
+    size_t rowsTaken = 0;
+    detail::RuntimeDialect dialect;
+    std::vector<std::string> headerRow;
+    bool headerRead = false;
+};
+
+/// @brief Where a reader stopped, enough to carry on from there in another process
+struct checkpoint
+{
+    uint64_t offset = 0;  ///< byte offset of the next record
+    uint64_t row = 0;     ///< rows read before it
+    bool inQuotes = false; ///< whether offset is inside a quoted field
+    char delimiter = '\0';
+    std::vector<std::string> header;
+
+    /// @brief A single line of text that deserialize() reads back
+    std::string serialize() const
+    {
+        std::string text = "stdcsv-checkpoint 1 " + std::to_string(offset) + ' ' + std::to_string(row) + ' '
+                           + std::to_string(int(inQuotes)) + ' ' + std::to_string(int(delimiter)) + ' '
+                           + std::to_string(header.size());
+        for (const auto& name : header)
+        {
+            text += ' ' + std::to_string(name.size()) + ':' + name;
+        }
+        return text;
+    }
+
+    /// @return false if text is not a serialized checkpoint
+    static bool deserialize(std::string_view text, checkpoint& point)
+    {
+        constexpr std::string_view magic = "stdcsv-checkpoint 1 ";
+        if (text.substr(0, magic.size()) != magic)
+        {
+            return false;
+        }
+        text.remove_prefix(magic.size());
+        const auto read_number = [&text](auto& value, char separator)
+        {
+            const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (error != std::errc() || end == text.data() + text.size() || *end != separator)
+            {
+                return false;
+            }
+            text.remove_prefix(static_cast<size_t>(end - text.data()) + 1);
+            return true;
+        };
+        checkpoint result;
+        int quoted = 0;
+        int delimiter = 0;
+        size_t nColumns = 0;
+        if (!read_number(result.offset, ' ') || !read_number(result.row, ' ') || !read_number(quoted, ' ')
+            || !read_number(delimiter, ' '))
+        {
+            return false;
+        }
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), nColumns);
+        if (error != std::errc() || nColumns > text.size())
+        {
+            return false;
+        }
+        text.remove_prefix(static_cast<size_t>(end - text.data()));
+        for (size_t size = 0; result.header.size() < nColumns; text.remove_prefix(size))
+        {
+            if (text.empty() || text.front() != ' ')
+            {
+                return false;
+            }
+            text.remove_prefix(1);
+            if (!read_number(size, ':') || size > text.size())
+            {
+                return false;
+            }
+            result.header.emplace_back(text.substr(0, size));
+        }
+        if (!text.empty())
+        {
+            return false;
+        }
+        result.inQuotes = quoted != 0;
+        result.delimiter = static_cast<char>(delimiter);
+        point = std::move(result);
+        return true;
+    }
+
+    /// @brief Writes the checkpoint to a file that is replaced at once, so a crash leaves the old or the new one
+    /// On POSIX systems the new file is synced to disk before it replaces the old one, and the directory after, so
+    /// this holds after a power loss too; elsewhere only a crash of the process is covered.
+    bool save(const std::string& path) const
+    {
+        const auto temporary = path + ".tmp";
+        const auto text = serialize() + '\n';
+#if defined(__unix__) || defined(__APPLE__)
+        const auto descriptor = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (descriptor < 0)
+        {
+            return false;
+        }
+        bool written = true;
+        for (size_t offset = 0; written && offset < text.size();)
+        {
+            const auto size = ::write(descriptor, text.data() + offset, text.size() - offset);
+            written = size > 0 || (size < 0 && errno == EINTR);
+            offset += size > 0 ? static_cast<size_t>(size) : 0;
+        }
+        written = written && ::fsync(descriptor) == 0;
+        written = ::close(descriptor) == 0 && written;
+        if (!written)
+        {
+            return false;
+        }
+#else
+        if (!(std::ofstream(temporary, std::ios::binary | std::ios::trunc) << text))
+        {
+            return false;
+        }
+#endif
+        std::error_code error;
+        std::filesystem::rename(temporary, path, error);
+        if (error)
+        {
+            return false;
+        }
+#if defined(__unix__) || defined(__APPLE__)
+        // The rename lasts once the directory entry that it changed is on disk
+        const auto directory = std::filesystem::path(path).parent_path();
+        const auto directoryDescriptor = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (directoryDescriptor >= 0)
+        {
+            ::fsync(directoryDescriptor);
+            ::close(directoryDescriptor);
+        }
+#endif
+        return true;
+    }
+
+    /// @return false if there is no valid checkpoint at path
+    static bool load(const std::string& path, checkpoint& point)
+    {
+        std::string text;
+        auto file = std::ifstream(path, std::ios::binary);
+        return std::getline(file, text) && deserialize(text, point);
+    }
+};
+
+/// @brief Reads a CSV file one row at a time, and can stop and carry on later from a checkpoint
+/// With a csv::dialect for DialectT, its delimiter, quote and line break replace those of the options.
+template<typename RowT, typename DialectT = detail::RuntimeDialect>
+class reader
+{
+public:
+    using row_type = decltype(detail::parse_record<RowT>({}, DialectT{}));
+
+    explicit reader(const std::string& path, const read_options& options = {}, bool withHeader = false)
+            : file(path, std::ios::binary), options(dialect_options(options)), records(file, this->options)
+    {
+        detail::Instrument<false> instrument;
+        records.skip_lines(options.skipRows, instrument);
+        if constexpr (detail::IsRuntimeDialect<DialectT>::value)
+        {
+            dialect = {detail::get_delimiter(records, options.delimiter, instrument), options.quote, options.lineBreak};
+        }
+        if (std::string_view record; withHeader && records.next(record))
+        {
+            headerRow = detail::parse_record<std::vector<std::string>>(record, dialect);
+        }
+    }
+
+    /// @brief Carries on from where the reader that made from stopped
+    reader(const std::string& path, const checkpoint& from, const read_options& options = {})
+            : file(seek(path, from.offset)), options(dialect_options(options)), records(file, this->options),
+              headerRow(from.header), rowNumber(from.row)
+    {
+        if constexpr (detail::IsRuntimeDialect<DialectT>::value)
+        {
+            dialect = {from.delimiter, options.quote, options.lineBreak};
+        }
+        records.resume(from.inQuotes);
+    }
+
+    reader(const reader&) = delete;
+    reader& operator=(const reader&) = delete;
+
+    explicit operator bool() const
+    {
+        return file.is_open();
+    }
+
+    /// @brief Reads the next row that passes the filter of the options
+    /// @return false at the end of the file or once maxRows rows have been read
+    bool next(row_type& row)
+    {
+        for (std::string_view record; rowNumber < options.maxRows && records.next(record);)
+        {
+            if (!options.filter || detail::keep_record(record, dialect, options))
+            {
+                row = detail::parse_record<RowT>(record, dialect);
+                ++rowNumber;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Reads the rows in a range-based for loop; each row read replaces the one before it
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = row_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const row_type*;
+        using reference = const row_type&;
+
+        iterator() = default;
+
+        explicit iterator(reader& source) : source(&source)
+        {
+            ++*this;
+        }
+
+        reference operator*() const
+        {
+            return row;
+        }
+
+        pointer operator->() const
+        {
+            return &row;
+        }
+
+        iterator& operator++()
+        {
+            if (!source->next(row))
+            {
+                source = nullptr;
+            }
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const
+        {
+            return source == other.source;
+        }
+
+        bool operator!=(const iterator& other) const
+        {
+            return source != other.source;
+        }
+
+    private:
+        reader* source = nullptr;
+        row_type row;
+    };
+
+    iterator begin()
+    {
+        return iterator(*this);
+    }
+
+    iterator end()
+    {
+        return {};
+    }
+
+    /// @brief Where the next row starts
+    checkpoint position() const
+    {
+        return {records.offset(), rowNumber, records.in_quotes(), dialect.delimiter, headerRow};
+    }
+
+    const std::vector<std::string>& header() const
+    {
+        return headerRow;
+    }
+
+    /// @brief Rows read, counting those read before the checkpoint this reader started from
+    uint64_t rows() const
+    {
+        return rowNumber;
+    }
+
+private:
+    static read_options dialect_options(read_options options)
+    {
+        if constexpr (!detail::IsRuntimeDialect<DialectT>::value)
+        {
+            options.delimiter = DialectT::delimiter;
+            options.quote = DialectT::quote;
+            options.lineBreak = DialectT::lineBreak;
+        }
+        return options;
+    }
+
+    static std::ifstream seek(const std::string& path, uint64_t offset)
+    {
+        std::ifstream file(path, std::ios::binary);
+        file.seekg(static_cast<std::streamoff>(offset));
+        return file;
+    }
+
+    std::ifstream file;
+    read_options options;
+    detail::RecordReader records;
+    DialectT dialect;
+    std::vector<std::string> headerRow;
+    uint64_t rowNumber = 0;
+};
+
+#if defined(__cpp_impl_coroutine)
+/// @brief The values a coroutine yields, computed as they are iterated over
+template<typename T>
+class generator
+{
+public:
+    struct promise_type
+    {
+        const T* value = nullptr;
+
+        generator get_return_object()
+        {
+            return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_always yield_value(const T& yielded) noexcept
+        {
+            value = &yielded;
+            return {};
+        }
+
+        void return_void() noexcept { }
+
+        void unhandled_exception()
+        {
+            throw;
+        }
+    };
+
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        explicit iterator(std::coroutine_handle<promise_type> coroutine) : coroutine(coroutine) { }
+
+        const T& operator*() const
+        {
+            return *coroutine.promise().value;
+        }
+
+        iterator& operator++()
+        {
+            coroutine.resume();
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        bool operator==(std::default_sentinel_t) const
+        {
+            return coroutine.done();
+        }
+
+    private:
+        std::coroutine_handle<promise_type> coroutine;
+    };
+
+    generator(generator&& other) noexcept : coroutine(std::exchange(other.coroutine, {})) { }
+
+    generator& operator=(generator&& other) noexcept
+    {
+        std::swap(coroutine, other.coroutine);
+        return *this;
+    }
+
+    ~generator()
+    {
+        if (coroutine)
+        {
+            coroutine.destroy();
+        }
+    }
+
+    /// @brief Runs the coroutine to its first value; a generator is iterated over once
+    iterator begin()
+    {
+        coroutine.resume();
+        return iterator(coroutine);
+    }
+
+    std::default_sentinel_t end() const
+    {
+        return {};
+    }
+
+private:
+    explicit generator(std::coroutine_handle<promise_type> coroutine) : coroutine(coroutine) { }
+
+    std::coroutine_handle<promise_type> coroutine;
+};
+
+/// @brief The rows of a file, read one block at a time as they are iterated over
+template<typename... ColumnTs>
+generator<FilteredTuple<ColumnTs...>> rows(std::string path, read_options options = {}, bool withHeader = false)
+{
+    reader<std::tuple<ColumnTs...>> source(path, options, withHeader);
+    for (FilteredTuple<ColumnTs...> row; source.next(row);)
+    {
+        co_yield row;
+    }
+}
+
+namespace detail
+{
+
+/// @brief One background thread that runs the blocking reads of all the async readers, in the order asked for
+class IoThread
+{
+public:
+    static IoThread& instance()
+    {
+        static IoThread thread;
+        return thread;
+    }
+
+    void post(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(std::move(job));
+        }
+        wakeUp.notify_one();
+    }
+
+    ~IoThread()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_one();
+        worker.join();
+    }
+
+private:
+    IoThread() : worker([this] { run(); }) { }
+
+    void run()
+    {
+        while (true)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeUp.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (jobs.empty())
+                {
+                    return;
+                }
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::deque<std::function<void()>> jobs;
+    bool stopping = false;
+    std::thread worker;
+};
+} // namespace detail
+
+/// @brief Reads rows in a coroutine without blocking its thread on the file
+/// co_await next(row) takes a row from the data already read if it can. Otherwise the coroutine is suspended while
+/// a background thread shared by all async readers reads blocks until a row is complete, and is then resumed through
+/// post, or on that thread if post is empty. An event loop that runs what is posted to it can so interleave many
+/// readers on one thread. Skipped lines, comments, the header and the filter of the options are handled while the
+/// blocks are read, so the filter may be called on the background thread. A reader must outlive the next() it
+/// awaits, and must not be used again until that returns.
+template<typename RowT>
+class async_reader
+{
+public:
+    using row_type = decltype(detail::parse_record<RowT>({}, detail::RuntimeDialect{}));
+    using executor = std::function<void(std::coroutine_handle<>)>;
+
+    explicit async_reader(const std::string& path,
+                          const read_options& options = {},
+                          bool withHeader = false,
+                          executor post = {},
+                          size_t blockSize = size_t(1) << 20)
+            : file(path, std::ios::binary), options(options), withHeader(withHeader), post(std::move(post)),
+              blockSize(std::max<size_t>(blockSize, 1))
+    {
+        dialect.quote = options.quote;
+        dialect.lineBreak = options.lineBreak;
+    }
+
+    async_reader(const async_reader&) = delete;
+    async_reader& operator=(const async_reader&) = delete;
+
+    explicit operator bool() const
+    {
+        return file.is_open();
+    }
+
+    /// @brief Awaits the next row that passes the filter of the options
+    /// @return An awaitable that gives false at the end of the file or once maxRows rows have been read
+    auto next(row_type& row)
+    {
+        struct NextRow
+        {
+            async_reader& source;
+            row_type& row;
+
+            bool await_ready()
+            {
+                return source.advance();
+            }
+
+            void await_suspend(std::coroutine_handle<> coroutine)
+            {
+                source.fill(coroutine);
+            }
+
+            bool await_resume()
+            {
+                return source.take(row);
+            }
+        };
+        return NextRow{*this, row};
+    }
+
+    /// @brief The header, once the first row has been awaited
+    const std::vector<std::string>& header() const
+    {
+        return headerRow;
+    }
+
+    uint64_t rows() const
+    {
+        return rowNumber;
+    }
+
+private:
+    /// @brief Takes the next whole record off the data read, or the rest of it once the file has ended
+    bool take_record(std::string_view& record)
+    {
+        const auto data = buffer.data();
+        auto recordEnd = detail::find_record_end(data + scanned, data + buffer.size(), inQuotes, options.quote,
+                                                 options.lineBreak);
+        if (!recordEnd)
+        {
+            scanned = buffer.size();
+            if (!ended || begin == buffer.size())
+            {
+                return false;
+            }
+            recordEnd = data + buffer.size();
+        }
+        record = std::string_view(data + begin, static_cast<size_t>(recordEnd - data) - begin);
+        begin = scanned = std::min(buffer.size(), static_cast<size_t>(recordEnd - data) + 1);
+        inQuotes = false;
+        if (options.lineBreak == '\n' && !record.empty() && record.back() == '\r')
+        {
+            record.remove_suffix(1);
+        }
+        return true;
+    }
+
+    /// @brief Finds the next row in the data read, passing over skipped lines, comments, the header and filtered
+    /// records
+    /// @return false if more of the file is needed to tell
+    bool advance()
+    {
+        const auto& prefix = options.commentPrefix;
+        while (!hasPending && rowNumber < options.maxRows)
+        {
+            std::string_view record;
+            if (!take_record(record))
+            {
+                return ended;
+            }
+            if (skipped < options.skipRows)
+            {
+                ++skipped;
+                continue;
+            }
+            if (!prefix.empty() && record.substr(0, prefix.size()) == prefix)
+            {
+                continue;
+            }
+            if (!started)
+            {
+                started = true;
+                dialect.delimiter = options.delimiter == '\0' ? detail::get_delimiter(record) : options.delimiter;
+                if (withHeader)
+                {
+                    headerRow = detail::parse_record<std::vector<std::string>>(record, dialect);
+                    continue;
+                }
+            }
+            if (!options.filter || detail::keep_record(record, dialect, options))
+            {
+                pending = record;
+                hasPending = true;
+            }
+        }
+        return true;
+    }
+
+    /// @brief Reads blocks on the background thread until advance() finds a row or the end, then resumes coroutine
+    /// An exception, such as from the filter, is kept to be thrown by the awaited next() in the coroutine.
+    void fill(std::coroutine_handle<> coroutine)
+    {
+        detail::IoThread::instance().post([this, coroutine]
+        {
+            try
+            {
+                buffer.erase(0, begin);
+                scanned -= begin;
+                begin = 0;
+                while (!advance())
+                {
+                    const auto size = buffer.size();
+                    buffer.resize(size + blockSize);
+                    file.read(buffer.data() + size, static_cast<std::streamsize>(blockSize));
+                    buffer.resize(size + static_cast<size_t>(file.gcount()));
+                    ended = buffer.size() == size;
+                }
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            // The coroutine may destroy this reader as soon as it runs again
+            if (auto resume = post)
+            {
+                resume(coroutine);
+            }
+            else
+            {
+                coroutine.resume();
+            }
+        });
+    }
+
+    bool take(row_type& row)
+    {
+        if (error)
+        {
+            std::rethrow_exception(std::exchange(error, nullptr));
+        }
+        if (!hasPending)
+        {
+            return false;
+        }
+        hasPending = false;
+        ++rowNumber;
+        row = detail::parse_record<RowT>(pending, dialect);
+        return true;
+    }
+
+    std::ifstream file;
+    read_options options;
+    bool withHeader;
+    executor post;
+    size_t blockSize;
+    detail::RuntimeDialect dialect;
+    std::string buffer;
+    size_t begin = 0;   ///< start of the next record
+    size_t scanned = 0; ///< how far the next record has been searched for its end
+    bool inQuotes = false;
+    bool ended = false;
+    size_t skipped = 0;
+    bool started = false;
+    std::vector<std::string> headerRow;
+    std::string_view pending; ///< the record of the next row, once advance() has found it
+    bool hasPending = false;
+    uint64_t rowNumber = 0;
+    std::exception_ptr error; ///< thrown on the background thread, to be rethrown in the coroutine
+};
+#endif
+
+/// @brief The type of the values of a column, from the most specific to the most general
+enum class column_type
+{
+    boolean,  ///< true/false, yes/no or their first letters
+    integer,  ///< fits in int64_t
+    floating, ///< any number, including inf and nan
+    date,     ///< YYYY-MM-DD, optionally followed by T or a space and hh:mm[:ss[.fff]][Z]
+    string
+};
+
+struct column_schema
+{
+    std::string name;
+    column_type type = column_type::string;
+    bool nullable = false; ///< whether some fields are empty, NA, N/A, NULL or null
+};
+
+/// @brief The columns of a CSV file as infer_schema() guesses them from a sample; any of it can be corrected before
+/// loading a table with it
+struct schema
+{
+    std::vector<column_schema> columns;
+    bool header = false; ///< whether the first record names the columns
+    char delimiter = ',';
+};
+
+namespace detail
+{
+
+/// @defgroup Type inference
+/// @{
+inline bool is_null(std::string_view field)
+{
+    return field.empty() || field == "NA" || field == "N/A" || field == "NULL" || field == "null";
+}
+
+/// @brief Days from 1970-01-01 to a date of the proleptic Gregorian calendar
+inline int64_t days_from_civil(int64_t year, unsigned month, unsigned day)
+{
+    year -= month <= 2;
+    const auto era = (year >= 0 ? year : year - 399) / 400;
+    const auto yearOfEra = static_cast<unsigned>(year - era * 400);
+    const auto dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const auto dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+}
+
+/// @brief Parses a whole field as YYYY-MM-DD, optionally followed by T or a space and hh:mm[:ss[.fff]][Z], in UTC
+/// @return false if the field is anything else
+inline bool parse_date(std::string_view field, std::chrono::system_clock::time_point& value)
+{
+    size_t position = 0;
+    const auto number = [&](size_t digits, unsigned& result)
+    {
+        result = 0;
+        for (size_t end = position + digits; position < end; ++position)
+        {
+            if (position >= field.size() || !is_digit(field[position]))
+            {
+                return false;
+            }
+            result = result * 10 + static_cast<unsigned>(field[position] - '0');
+        }
+        return true;
+    };
+    const auto separator = [&](std::string_view characters)
+    {
+        return position < field.size() && characters.find(field[position++]) != characters.npos;
+    };
+    unsigned year, month, day, hours = 0, minutes = 0, seconds = 0;
+    if (!number(4, year) || !separator("-") || !number(2, month) || !separator("-") || !number(2, day)
+        || month < 1 || month > 12 || day < 1 || day > 31)
+    {
+        return false;
+    }
+    std::chrono::nanoseconds fraction{};
+    if (position < field.size())
+    {
+        if (!separator("T ") || !number(2, hours) || !separator(":") || !number(2, minutes) || hours > 23
+            || minutes > 59)
+        {
+            return false;
+        }
+        if (position < field.size() && field[position] == ':')
+        {
+            ++position;
+            if (!number(2, seconds) || seconds > 60)
+            {
+                return false;
+            }
+            if (position < field.size() && field[position] == '.')
+            {
+                int64_t scale = 1000000000;
+                for (++position; position < field.size() && is_digit(field[position]); ++position)
+                {
+                    scale /= 10;
+                    fraction += std::chrono::nanoseconds((field[position] - '0') * scale);
+                }
+            }
+        }
+        if (position < field.size() && field[position] == 'Z')
+        {
+            ++position;
+        }
+        if (position != field.size())
+        {
+            return false;
+        }
+    }
+    const auto time = std::chrono::hours(days_from_civil(year, month, day) * 24 + hours)
+                      + std::chrono::minutes(minutes) + std::chrono::seconds(seconds) + fraction;
+    value = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(time));
+    return true;
+}
+
+/// @brief The most specific type the whole field can be read as
+inline column_type classify(std::string_view field)
+{
+    if (field.empty())
+    {
+        return column_type::string;
+    }
+    // A number: [+-]digits[.digits][(e|E)[+-]digits], or inf and nan
+    size_t position = field.size() > 1 && (field[0] == '-' || field[0] == '+');
+    const auto digits = [&]
+    {
+        const auto begin = position;
+        while (position < field.size() && is_digit(field[position]))
+        {
+            ++position;
+        }
+        return position - begin;
+    };
+    auto nDigits = digits();
+    bool integral = nDigits > 0;
+    if (position < field.size() && field[position] == '.')
+    {
+        ++position;
+        nDigits += digits();
+        integral = false;
+    }
+    if (nDigits > 0 && position < field.size() && (field[position] | 0x20) == 'e')
+    {
+        ++position;
+        position += position < field.size() && (field[position] == '-' || field[position] == '+');
+        integral = false;
+        nDigits = digits() > 0 ? nDigits : 0;
+    }
+    if (nDigits > 0 && position == field.size())
+    {
+        int64_t value;
+        return integral && parse_integer(field.data(), field.data() + field.size(), value)
+               ? column_type::integer : column_type::floating;
+    }
+    const auto lower = [&field](size_t begin)
+    {
+        std::string word(field.substr(begin));
+        std::transform(word.begin(), word.end(), word.begin(), [](char c) { return static_cast<char>(c | 0x20); });
+        return word;
+    };
+    const auto word = lower(0);
+    const auto unsignedWord = lower(field[0] == '-' || field[0] == '+');
+    if (unsignedWord == "inf" || unsignedWord == "infinity" || unsignedWord == "nan")
+    {
+        return column_type::floating;
+    }
+    if (word == "true" || word == "false" || word == "yes" || word == "no" || word == "t" || word == "f"
+        || word == "y" || word == "n")
+    {
+        return column_type::boolean;
+    }
+    std::chrono::system_clock::time_point date;
+    return parse_date(field, date) ? column_type::date : column_type::string;
+}
+
+/// @brief The types seen in a column's sample
+struct ColumnGuess
+{
+    unsigned types = 0; ///< bit per column_type
+    bool nullable = false;
+
+    void add(std::string_view field)
+    {
+        if (is_null(field))
+        {
+            nullable = true;
+        }
+        else
+        {
+            types |= 1u << static_cast<unsigned>(classify(field));
+        }
+    }
+
+    void merge(const ColumnGuess& other)
+    {
+        types |= other.types;
+        nullable |= other.nullable;
+    }
+
+    /// @brief The one type that all the values seen can be read as
+    column_type type() const
+    {
+        constexpr auto bit = [](column_type type) { return 1u << static_cast<unsigned>(type); };
+        const auto numbers = bit(column_type::integer) | bit(column_type::floating);
+        if (types == bit(column_type::boolean) || types == bit(column_type::integer) || types == bit(column_type::date))
+        {
+            return static_cast<column_type>(trailing_zeroes(types));
+        }
+        return types != 0 && (types & ~numbers) == 0 ? column_type::floating : column_type::string;
+    }
+};
+
+/// @brief Calls function(record) for the records of text that are not comments, up to maxRecords
+/// If function returns a bool, only the records for which it returns true count towards maxRecords, so that a row
+/// limit applies to the rows kept by a filter.
+template<typename Function>
+void for_each_record(std::string_view text,
+                     const read_options& options,
+                     size_t maxRecords,
+                     Function&& function)
+{
+    const auto& prefix = options.commentPrefix;
+    for (size_t position = 0, taken = 0; position < text.size() && taken < maxRecords;)
+    {
+        bool inQuotes = false;
+        const auto first = text.data() + position;
+        const auto last = text.data() + text.size();
+        const auto isComment = !prefix.empty() && text.substr(position, prefix.size()) == prefix;
+        auto end = isComment ? static_cast<const char*>(std::memchr(first, options.lineBreak, last - first))
+                             : find_record_end(first, last, inQuotes, options.quote, options.lineBreak);
+        end = end ? end : last;
+        auto record = std::string_view(first, static_cast<size_t>(end - first));
+        position += record.size() + 1;
+        if (options.lineBreak == '\n' && !record.empty() && record.back() == '\r')
+        {
+            record.remove_suffix(1);
+        }
+        if (isComment)
+        {
+            continue;
+        }
+        if constexpr (std::is_same_v<decltype(function(record)), bool>)
+        {
+            taken += function(record) ? 1 : 0;
+        }
+        else
+        {
+            function(record);
+            ++taken;
+        }
+    }
+}
+
+/// @brief The offset in text just past the line break that ends record, a view into text
+inline size_t record_end(std::string_view text, std::string_view record, char lineBreak)
+{
+    const auto lineEnd = text.find(lineBreak, static_cast<size_t>(record.data() - text.data()) + record.size());
+    return lineEnd == text.npos ? text.size() : lineEnd + 1;
+}
+
+/// @brief The fields of a record with their quotes removed
+template<typename Dialect>
+std::vector<std::string> split_record(std::string_view record, const Dialect& dialect)
+{
+    std::vector<std::string> fields;
+    RecordCursor row{record};
+    do
+    {
+        fields.push_back(unquote(next_field(row, dialect), dialect.quote));
+    } while (!row.end);
+    return fields;
+}
+/// @}
+} // namespace detail
+
+/// @brief Guesses the columns of a file from sampleRows records, read from evenly spaced offsets in parallel
+/// Records are looked for at an offset from the line break after it, so a sample starting inside a quoted field
+/// that spans lines can be misaligned; records with another number of fields than the first are left out.
+inline schema infer_schema(std::string_view path,
+                           const read_options& options = {},
+                           size_t sampleRows = 10000,
+                           size_t threads = 0)
+{
+    const detail::MappedFile file(path);
+    if (!file)
+    {
+        return {};
+    }
+    auto text = file.view();
+    for (size_t i = 0; i < options.skipRows && !text.empty(); ++i)
+    {
+        const auto lineEnd = text.find(options.lineBreak);
+        text.remove_prefix(lineEnd == text.npos ? text.size() : lineEnd + 1);
+    }
+
+    // The first record decides the delimiter and the number of columns
+    std::string_view firstRecord;
+    bool found = false;
+    detail::for_each_record(text, options, 1, [&](std::string_view record)
+    {
+        firstRecord = record;
+        found = true;
+    });
+    if (!found)
+    {
+        return {};
+    }
+    schema result;
+    result.delimiter = options.delimiter == '\0' ? detail::get_delimiter(firstRecord) : options.delimiter;
+    const detail::RuntimeDialect dialect{result.delimiter, options.quote, options.lineBreak};
+    const auto firstFields = detail::split_record(firstRecord, dialect);
+    const auto nColumns = firstFields.size();
+    const auto body = text.substr(detail::record_end(text, firstRecord, options.lineBreak));
+
+    // Sample chunks of the rest of the file in parallel
+    constexpr size_t minChunkSize = size_t(1) << 16;
+    const auto nChunks = std::max<size_t>(1, std::min(detail::thread_count(threads), body.size() / minChunkSize));
+    const auto rowsPerChunk = (sampleRows + nChunks - 1) / nChunks;
+    std::vector<std::vector<detail::ColumnGuess>> guesses(nChunks, std::vector<detail::ColumnGuess>(nColumns));
+    detail::parallel_for(nChunks, nChunks, [&](size_t chunk)
+    {
+        auto sample = body.substr(body.size() / nChunks * chunk);
+        if (chunk > 0)
+        {
+            const auto lineEnd = sample.find(options.lineBreak);
+            sample.remove_prefix(lineEnd == sample.npos ? sample.size() : lineEnd + 1);
+        }
+        detail::for_each_record(sample, options, rowsPerChunk, [&](std::string_view record)
+        {
+            const auto fields = detail::split_record(record, dialect);
+            if (fields.size() == nColumns || chunk == 0)
+            {
+                for (size_t i = 0; i < std::min(nColumns, fields.size()); ++i)
+                {
+                    guesses[chunk][i].add(fields[i]);
+                }
+            }
+        });
+    });
+    auto& columns = guesses.front();
+    for (size_t chunk = 1; chunk < nChunks; ++chunk)
+    {
+        for (size_t i = 0; i < nColumns; ++i)
+        {
+            columns[i].merge(guesses[chunk][i]);
+        }
+    }
+
+    // The first record is a header if its fields do not fit the types of their columns
+    int votes = 0;
+    bool allStrings = true;
+    for (size_t i = 0; i < nColumns; ++i)
+    {
+        if (const auto type = columns[i].type(); columns[i].types != 0 && type != column_type::string)
+        {
+            allStrings = false;
+            // A null could be a value of any type, so it has no say
+            if (detail::is_null(firstFields[i]))
+            {
+                continue;
+            }
+            const auto firstType = detail::classify(firstFields[i]);
+            votes += firstType == type || (type == column_type::floating && firstType == column_type::integer)
+                     ? -1 : 1;
+        }
+    }
+    if (allStrings)
+    {
+        // Only names that are all different and not empty are taken for a header
+        auto sorted = firstFields;
+        std::sort(sorted.begin(), sorted.end());
+        result.header = std::adjacent_find(sorted.cbegin(), sorted.cend()) == sorted.cend()
+                        && std::none_of(sorted.cbegin(), sorted.cend(), detail::is_null);
+    }
+    else
+    {
+        result.header = votes > 0;
+    }
+    for (size_t i = 0; i < nColumns; ++i)
+    {
+        if (!result.header)
+        {
+            columns[i].add(firstFields[i]);
+        }
+        result.columns.push_back({result.header ? firstFields[i] : std::string(), columns[i].type(),
+                                  columns[i].nullable});
+    }
+    return result;
+}
+
+/// @brief A CSV file loaded into a typed vector per column
+class table
+{
+public:
+    using column_data = std::variant<std::vector<bool>,
+                                     std::vector<int64_t>,
+                                     std::vector<double>,
+                                     std::vector<std::chrono::system_clock::time_point>,
+                                     std::vector<std::string>>;
+
+    struct column
+    {
+        column_schema schema;
+        column_data data;        ///< the alternative of schema.type
+        std::vector<bool> nulls; ///< per row if schema.nullable; null values are zero, NaN or empty
+    };
+
+    size_t rows() const
+    {
+        return nRows;
+    }
+
+    size_t columns() const
+    {
+        return columnData.size();
+    }
+
+    const column& operator[](size_t index) const
+    {
+        return columnData[index];
+    }
+
+    /// @return nullptr if there is no column named name
+    const column* find(std::string_view name) const
+    {
+        const auto found = std::find_if(columnData.cbegin(), columnData.cend(),
+                                        [name](const column& c) { return c.schema.name == name; });
+        return found == columnData.cend() ? nullptr : &*found;
+    }
+
+    /// @brief The values of a column, whose type must be T
+    template<typename T>
+    const std::vector<T>& values(size_t index) const
+    {
+        return std::get<std::vector<T>>(columnData[index].data);
+    }
+
+private:
+    friend table read_table(std::string_view path, const schema& columns, const read_options& options);
+
+    /// @brief Converts a field into the column; one that is null or does not convert makes the column nullable
+    void add(column& target, std::string_view field, char quote)
+    {
+        const auto value = detail::strip_quotes(field, quote);
+        bool converted = !detail::is_null(value);
+        std::visit([&](auto& values)
+        {
+            using T = typename std::decay_t<decltype(values)>::value_type;
+            if constexpr (std::is_same_v<T, std::string>)
+            {
+                values.push_back(converted ? detail::unquote(field, quote) : std::string());
+            }
+            else if constexpr (std::is_same_v<T, std::chrono::system_clock::time_point>)
+            {
+                T date{};
+                converted = converted && detail::parse_date(value, date);
+                values.push_back(date);
+            }
+            else
+            {
+                T number{};
+                converted = converted && detail::parse_value(value, number);
+                values.push_back(converted || !std::is_floating_point_v<T>
+                                 ? number : std::numeric_limits<T>::quiet_NaN());
+            }
+        }, target.data);
+        if (!converted && !target.schema.nullable)
+        {
+            target.schema.nullable = true;
+            target.nulls.assign(nRows, false);
+        }
+        if (target.schema.nullable)
+        {
+            target.nulls.push_back(!converted);
+        }
+    }
+
+    std::vector<column> columnData;
+    size_t nRows = 0;
+};
+
+/// @brief Loads a file into columns of the types given
+/// Each field is converted straight into the vector of its column. Fields that do not convert are stored as nulls.
+inline table read_table(std::string_view path, const schema& columns, const read_options& options = {})
+{
+    table result;
+    for (const auto& columnSchema : columns.columns)
+    {
+        table::column target{columnSchema, {}, {}};
+        switch (columnSchema.type)
+        {
+            case column_type::boolean: target.data = std::vector<bool>(); break;
+            case column_type::integer: target.data = std::vector<int64_t>(); break;
+            case column_type::floating: target.data = std::vector<double>(); break;
+            case column_type::date: target.data = std::vector<std::chrono::system_clock::time_point>(); break;
+            case column_type::string: target.data = std::vector<std::string>(); break;
+        }
+        result.columnData.push_back(std::move(target));
+    }
+    auto file = std::ifstream(std::string(path), std::ios::binary);
+    if (!file || result.columnData.empty())
+    {
+        return result;
+    }
+    detail::RecordReader reader(file, options);
+    reader.skip_lines(options.skipRows);
+    if (std::string_view record; columns.header)
+    {
+        reader.next(record);
+    }
+    detail::with_dialect(columns.delimiter, options, [&](const auto& dialect)
+    {
+        for (std::string_view record; result.nRows < options.maxRows && reader.next(record);)
+        {
+            if (options.filter && !detail::keep_record(record, dialect, options))
+            {
+                continue;
+            }
+            detail::RecordCursor row{record};
+            for (auto& target : result.columnData)
+            {
+                result.add(target, detail::next_field(row, dialect), dialect.quote);
+            }
+            ++result.nRows;
+        }
+    });
+    return result;
+}
+
+/// @brief Loads a file into columns of the types infer_schema() guesses for them
+inline table read_table(std::string_view path, const read_options& options = {})
+{
+    return read_table(path, infer_schema(path, options), options);
+}
+
+/// @brief Summary statistics of the numbers in a column
+struct column_summary
+{
+    size_t count = 0;   ///< numbers
+    size_t nulls = 0;   ///< empty, NA, N/A, NULL or null fields
+    size_t invalid = 0; ///< other fields that are not numbers
+    double sum = 0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    double mean = 0;
+    double m2 = 0; ///< sum of squared differences from the mean
+
+    /// @brief The sample variance, updated with Welford's method as numbers are added
+    double variance() const
+    {
+        return count > 1 ? m2 / static_cast<double>(count - 1) : 0;
+    }
+
+    double stddev() const
+    {
+        return std::sqrt(variance());
+    }
+
+    void add(double value)
+    {
+        ++count;
+        sum += value;
+        min = std::min(min, value);
+        max = std::max(max, value);
+        const auto delta = value - mean;
+        mean += delta / static_cast<double>(count);
+        m2 += delta * (value - mean);
+    }
+
+    /// @brief Combines the summaries of two parts of a column (Chan et al.)
+    void merge(const column_summary& other)
+    {
+        if (other.count > 0)
+        {
+            const auto total = static_cast<double>(count + other.count);
+            const auto delta = other.mean - mean;
+            mean += delta * static_cast<double>(other.count) / total;
+            m2 += other.m2 + delta * delta * static_cast<double>(count) * static_cast<double>(other.count) / total;
+            count += other.count;
+            sum += other.sum;
+            min = std::min(min, other.min);
+            max = std::max(max, other.max);
+        }
+        nulls += other.nulls;
+        invalid += other.invalid;
+    }
+};
+
+namespace detail
+{
+
+/// @brief Splits text into about nChunks ranges of whole records, finding the quote state at each split in parallel
+inline std::vector<std::string_view> split_records(std::string_view text, size_t nChunks, size_t nThreads)
+{
+    nChunks = std::max<size_t>(1, std::min(nChunks, text.size() / (1 << 16)));
+    const auto chunkSize = (text.size() + nChunks - 1) / nChunks;
+    std::vector<char> oddQuotes(nChunks);
+    parallel_for(nChunks, nThreads, [&](size_t i)
+    {
+        const auto first = std::min(text.size(), i * chunkSize);
+        const auto last = std::min(text.size(), first + chunkSize);
+        oddQuotes[i] = count_lines(text.data() + first, text.data() + last, true).oddQuotes;
+    });
+    // Each range starts after the first record end past its split
+    std::vector<size_t> starts(nChunks + 1, text.size());
+    starts[0] = 0;
+    bool inQuotes = false;
+    for (size_t i = 1; i < nChunks; ++i)
+    {
+        inQuotes = inQuotes != static_cast<bool>(oddQuotes[i - 1]);
+        auto startsInQuotes = inQuotes;
+        const auto split = text.data() + i * chunkSize;
+        const auto recordEnd = find_record_end(split, text.data() + text.size(), startsInQuotes);
+        starts[i] = std::max(starts[i - 1], recordEnd ? static_cast<size_t>(recordEnd - text.data()) + 1 : text.size());
+    }
+    std::vector<std::string_view> ranges;
+    for (size_t i = 0; i < nChunks; ++i)
+    {
+        ranges.push_back(text.substr(starts[i], starts[i + 1] - starts[i]));
+    }
+    return ranges;
+}
+
+/// @brief Adds a field to a summary as a number, a null or an invalid field
+inline void add_field(column_summary& summary, std::string_view field, char quote)
+{
+    field = strip_quotes(field, quote);
+    double value;
+    if (is_null(field))
+    {
+        ++summary.nulls;
+    }
+    else if (parse_float(field.data(), field.data() + field.size(), value))
+    {
+        summary.add(value);
+    }
+    else
+    {
+        ++summary.invalid;
+    }
+}
+
+/// @brief Adds the fields of a record in the columns wanted, in ascending order, to their summaries with
+/// add(summary, field, quote)
+template<typename Dialect, typename State, typename AddField>
+void summarize_record(std::string_view record,
+                      const Dialect& dialect,
+                      const std::vector<size_t>& columns,
+                      std::vector<State>& summaries,
+                      AddField& addField)
+{
+    RecordCursor row{record};
+    const auto add = [&](State& summary, std::string_view field)
+    {
+        addField(summary, field, dialect.quote);
+    };
+    if (columns.empty())
+    {
+        for (size_t i = 0; !row.end; ++i)
+        {
+            if (i == summaries.size())
+            {
+                summaries.emplace_back();
+            }
+            add(summaries[i], next_field(row, dialect));
+        }
+        return;
+    }
+    std::string_view field;
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        // Columns are in ascending order, so a repeated column gets the field just taken
+        if (i == 0 || columns[i] != columns[i - 1])
+        {
+            while (row.column < columns[i] && !row.end)
+            {
+                next_field(row, dialect);
+            }
+            field = row.end ? std::string_view() : next_field(row, dialect);
+        }
+        add(summaries[i], field);
+    }
+}
+
+/// @brief The positions of columns in ascending order of their values
+inline std::vector<size_t> sorted_order(const std::vector<size_t>& columns)
+{
+    std::vector<size_t> order(columns.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&columns](size_t a, size_t b) { return columns[a] < columns[b]; });
+    return order;
+}
+
+/// @brief Finds the records of a mapped file, after the skipped lines and the header if it is wanted
+/// @param delimiter the delimiter of the options, or the one detected from the first record
+/// @return text without the skipped lines and the header
+inline std::string_view find_records(std::string_view text,
+                                     const read_options& options,
+                                     std::vector<std::string>* header,
+                                     char& delimiter)
+{
+    for (size_t i = 0; i < options.skipRows && !text.empty(); ++i)
+    {
+        const auto lineEnd = text.find(options.lineBreak);
+        text.remove_prefix(lineEnd == text.npos ? text.size() : lineEnd + 1);
+    }
+    delimiter = options.delimiter;
+    size_t headerEnd = 0;
+    for_each_record(text, options, 1, [&](std::string_view record)
+    {
+        delimiter = delimiter == '\0' ? get_delimiter(record) : delimiter;
+        if (header)
+        {
+            *header = split_record(record, RuntimeDialect{delimiter, options.quote, options.lineBreak});
+            headerEnd = record_end(text, record, options.lineBreak);
+        }
+    });
+    delimiter = delimiter == '\0' ? ',' : delimiter;
+    return text.substr(headerEnd);
+}
+
+/// @brief Summarizes the records of text into a State per column, in parallel unless a row limit needs them in
+/// order; partial states are combined with State::merge
+template<typename State, typename AddField>
+std::vector<State> summarize(std::string_view text,
+                             char delimiter,
+                             std::vector<size_t> columns,
+                             const read_options& options,
+                             size_t threads,
+                             AddField addField)
+{
+    // Columns are taken from each record in ascending order
+    const auto order = sorted_order(columns);
+    std::vector<size_t> sortedColumns;
+    for (const auto i : order)
+    {
+        sortedColumns.push_back(columns[i]);
+    }
+
+    const auto nThreads = thread_count(threads);
+    const auto parallel = options.maxRows == std::numeric_limits<size_t>::max() && options.quote == '"'
+                          && options.lineBreak == '\n';
+    const auto ranges = split_records(text, parallel ? nThreads * 4 : 1, nThreads);
+    std::vector<std::vector<State>> partials(ranges.size(), std::vector<State>(columns.size()));
+    with_dialect(delimiter, options, [&](const auto& dialect)
+    {
+        parallel_for(ranges.size(), nThreads, [&](size_t i)
+        {
+            for_each_record(ranges[i], options, options.maxRows, [&](std::string_view record)
+            {
+                if (options.filter && !keep_record(record, dialect, options))
+                {
+                    return false;
+                }
+                summarize_record(record, dialect, sortedColumns, partials[i], addField);
+                return true;
+            });
+        });
+    });
+
+    auto summaries = std::move(partials.front());
+    for (size_t i = 1; i < partials.size(); ++i)
+    {
+        summaries.resize(std::max(summaries.size(), partials[i].size()));
+        for (size_t column = 0; column < partials[i].size(); ++column)
+        {
+            summaries[column].merge(partials[i][column]);
+        }
+    }
+    if (!columns.empty())
+    {
+        std::vector<State> unsorted(columns.size());
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            unsorted[order[i]] = summaries[i];
+        }
+        summaries = std::move(unsorted);
+    }
+    return summaries;
+}
+} // namespace detail
+
+/// @brief Summarizes the numbers in the given columns, or in all of them if none are given, without storing rows
+/// The file is memory-mapped and split into ranges of whole records that are summarized in parallel, then merged.
+/// @return A summary per column, in the order asked for
+inline std::vector<column_summary> aggregate(std::string_view path,
+                                             const std::vector<size_t>& columns = {},
+                                             const read_options& options = {},
+                                             size_t threads = 0)
+{
+    const detail::MappedFile file(path);
+    if (!file)
+    {
+        return {};
+    }
+    char delimiter;
+    const auto records = detail::find_records(file.view(), options, nullptr, delimiter);
+    return detail::summarize<column_summary>(records, delimiter, columns, options, threads, detail::add_field);
+}
+
+/// @brief Summarizes the numbers in the given columns after the header, which is read into header
+inline std::vector<column_summary> aggregate(std::string_view path,
+                                             std::vector<std::string>& header,
+                                             const std::vector<size_t>& columns = {},
+                                             const read_options& options = {},
+                                             size_t threads = 0)
+{
+    const detail::MappedFile file(path);
+    if (!file)
+    {
+        return {};
+    }
+    char delimiter;
+    const auto records = detail::find_records(file.view(), options, &header, delimiter);
+    return detail::summarize<column_summary>(records, delimiter, columns, options, threads, detail::add_field);
+}
+
+/// @brief Summaries of value columns for each distinct key, ordered by key
+struct groups
+{
+    std::vector<std::string> keys;
+    std::vector<column_summary> summaries; ///< of group g and value column v at g * nValues + v
+    size_t nValues = 0;
+
+    size_t size() const
+    {
+        return keys.size();
+    }
+
+    const column_summary& summary(size_t group, size_t value) const
+    {
+        return summaries[group * nValues + value];
+    }
+};
+
+namespace detail
+{
+
+/// @brief A fast non-cryptographic hash of a key, read eight bytes at a time
+inline uint64_t hash_bytes(std::string_view bytes)
+{
+    constexpr uint64_t multiplier = 0x9E3779B97F4A7C15;
+    uint64_t hash = bytes.size() * multiplier;
+    size_t i = 0;
+    for (; i + 8 <= bytes.size(); i += 8)
+    {
+        hash = (hash ^ read_eight_bytes(bytes.data() + i)) * multiplier;
+        hash ^= hash >> 29;
+    }
+    if (i < bytes.size())
+    {
+        uint64_t tail = 0;
+        std::memcpy(&tail, bytes.data() + i, bytes.size() - i);
+        hash = (hash ^ tail) * multiplier;
+    }
+    hash ^= hash >> 32;
+    hash *= multiplier;
+    return hash ^ (hash >> 29);
+}
+
+/// @brief Groups keyed by their bytes in an open-addressing table with linear probing
+/// Keys are copied into one buffer when their group is added, so looking up an existing group allocates nothing.
+class GroupTable
+{
+public:
+    explicit GroupTable(size_t nValues) : nValues(nValues), slots(64) { }
+
+    /// @brief The summaries of the group of key, which is added if it is new
+    column_summary* find_or_add(std::string_view key, uint64_t hash)
+    {
+        auto mask = slots.size() - 1;
+        for (auto i = hash & mask;; i = (i + 1) & mask)
+        {
+            auto& slot = slots[i];
+            if (slot.group == 0)
+            {
+                if ((hashes.size() + 1) * 2 > slots.size())
+                {
+                    grow();
+                    mask = slots.size() - 1;
+                    for (i = hash & mask; slots[i].group != 0; i = (i + 1) & mask)
+                    {
+                    }
+                }
+                slots[i] = {hash, hashes.size() + 1};
+                hashes.push_back(hash);
+                keyOffsets.push_back(keyBytes.size());
+                keyBytes.insert(keyBytes.end(), key.cbegin(), key.cend());
+                summaries.resize(summaries.size() + nValues);
+                return summaries.data() + (summaries.size() - nValues);
+            }
+            if (slot.hash == hash && this->key(slot.group - 1) == key)
+            {
+                return summaries.data() + (slot.group - 1) * nValues;
+            }
+        }
+    }
+
+    size_t size() const
+    {
+        return hashes.size();
+    }
+
+    std::string_view key(size_t group) const
+    {
+        const auto end = group + 1 < keyOffsets.size() ? keyOffsets[group + 1] : keyBytes.size();
+        return {keyBytes.data() + keyOffsets[group], end - keyOffsets[group]};
+    }
+
+    uint64_t hash(size_t group) const
+    {
+        return hashes[group];
+    }
+
+    const column_summary* values(size_t group) const
+    {
+        return summaries.data() + group * nValues;
+    }
+
+private:
+    struct Slot
+    {
+        uint64_t hash = 0;
+        size_t group = 0; ///< one more than the index of the group, or zero if the slot is empty
+    };
+
+    void grow()
+    {
+        std::vector<Slot> grown(slots.size() * 2);
+        const auto mask = grown.size() - 1;
+        for (const auto& slot : slots)
+        {
+            if (slot.group != 0)
+            {
+                auto i = slot.hash & mask;
+                for (; grown[i].group != 0; i = (i + 1) & mask)
+                {
+                }
+                grown[i] = slot;
+            }
+        }
+        slots = std::move(grown);
+    }
+
+    size_t nValues;
+    std::vector<Slot> slots;
+    std::vector<uint64_t> hashes;
+    std::vector<size_t> keyOffsets;
+    std::vector<char> keyBytes;
+    std::vector<column_summary> summaries;
+};
+
+/// @brief Adds a record to its group, taking the key and the values from one pass over its fields
+/// @param columns the key column followed by the value columns, in ascending order of column
+/// @param fields room for a field per column, by position in columns
+template<typename Dialect>
+void group_record(std::string_view record,
+                  const Dialect& dialect,
+                  const std::vector<size_t>& columns,
+                  const std::vector<size_t>& order,
+                  std::vector<std::string_view>& fields,
+                  GroupTable& table)
+{
+    RecordCursor row{record};
+    std::string_view field;
+    for (size_t k = 0; k < order.size(); ++k)
+    {
+        // A column repeated, as a value or as the key, gets the field just taken
+        const auto i = order[k];
+        if (k == 0 || columns[i] != columns[order[k - 1]])
+        {
+            while (row.column < columns[i] && !row.end)
+            {
+                next_field(row, dialect);
+            }
+            field = row.end ? std::string_view() : next_field(row, dialect);
+        }
+        fields[i] = field;
+    }
+    auto key = fields[0];
+    std::string unquoted;
+    if (!key.empty() && key.front() == dialect.quote)
+    {
+        // Escaped quotes are resolved into a copy; other quoted keys are used in place
+        const auto inner = strip_quotes(key, dialect.quote);
+        key = inner.size() + 2 >= key.size() ? inner : std::string_view(unquoted = unquote(key, dialect.quote));
+    }
+    auto summaries = table.find_or_add(key, hash_bytes(key));
+    for (size_t i = 1; i < fields.size(); ++i)
+    {
+        add_field(summaries[i - 1], fields[i], dialect.quote);
+    }
+}
+
+/// @brief Groups the records of text in a table per thread, then merges the tables in parallel by hash partition
+inline groups group_records(std::string_view text,
+                            char delimiter,
+                            size_t keyColumn,
+                            const std::vector<size_t>& valueColumns,
+                            const read_options& options,
+                            size_t threads)
+{
+    auto columns = valueColumns;
+    columns.insert(columns.begin(), keyColumn);
+    const auto order = sorted_order(columns);
+    const auto nValues = valueColumns.size();
+
+    const auto nThreads = thread_count(threads);
+    const auto parallel = options.maxRows == std::numeric_limits<size_t>::max() && options.quote == '"'
+                          && options.lineBreak == '\n';
+    const auto ranges = split_records(text, parallel ? nThreads : 1, nThreads);
+    std::vector<GroupTable> tables(ranges.size(), GroupTable(nValues));
+    with_dialect(delimiter, options, [&](const auto& dialect)
+    {
+        parallel_for(ranges.size(), nThreads, [&](size_t i)
+        {
+            std::vector<std::string_view> fields(columns.size());
+            for_each_record(ranges[i], options, options.maxRows, [&](std::string_view record)
+            {
+                if (options.filter && !keep_record(record, dialect, options))
+                {
+                    return false;
+                }
+                group_record(record, dialect, columns, order, fields, tables[i]);
+                return true;
+            });
+        });
+    });
+
+    // Each partition of the hash space is merged from all the tables by one thread
+    const auto nPartitions = tables.size() > 1 ? nThreads * 4 : 1;
+    std::vector<GroupTable> partitions(nPartitions, GroupTable(nValues));
+    parallel_for(nPartitions, nThreads, [&](size_t p)
+    {
+        for (const auto& table : tables)
+        {
+            for (size_t group = 0; group < table.size(); ++group)
+            {
+                if (const auto hash = table.hash(group); (hash >> 32) % nPartitions == p)
+                {
+                    auto summaries = partitions[p].find_or_add(table.key(group), hash);
+                    for (size_t v = 0; v < nValues; ++v)
+                    {
+                        summaries[v].merge(table.values(group)[v]);
+                    }
+                }
+            }
+        }
+    });
+
+    // Order the groups by key
+    std::vector<std::pair<std::string_view, const column_summary*>> merged;
+    for (const auto& partition : partitions)
+    {
+        for (size_t group = 0; group < partition.size(); ++group)
+        {
+            merged.emplace_back(partition.key(group), partition.values(group));
+        }
+    }
+    std::sort(merged.begin(), merged.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    groups result;
+    result.nValues = nValues;
+    result.keys.reserve(merged.size());
+    result.summaries.reserve(merged.size() * nValues);
+    for (const auto& [key, summaries] : merged)
+    {
+        result.keys.emplace_back(key);
+        result.summaries.insert(result.summaries.end(), summaries, summaries + nValues);
+    }
+    return result;
+}
+} // namespace detail
+
+/// @brief Summarizes the numbers in valueColumns for each distinct value of keyColumn, without storing rows
+/// Each thread groups a range of whole records of the memory-mapped file in its own hash table; the tables are then
+/// merged in parallel, a range of hashes per thread.
+inline groups group_by(std::string_view path,
+                       size_t keyColumn,
+                       const std::vector<size_t>& valueColumns,
+                       const read_options& options = {},
+                       size_t threads = 0)
+{
+    const detail::MappedFile file(path);
+    if (!file)
+    {
+        return {};
+    }
+    char delimiter;
+    const auto records = detail::find_records(file.view(), options, nullptr, delimiter);
+    return detail::group_records(records, delimiter, keyColumn, valueColumns, options, threads);
+}
+
+/// @brief Summarizes the numbers in valueColumns for each distinct value of keyColumn after the header, which is
+/// read into header
+inline groups group_by(std::string_view path,
+                       std::vector<std::string>& header,
+                       size_t keyColumn,
+                       const std::vector<size_t>& valueColumns,
+                       const read_options& options = {},
+                       size_t threads = 0)
+{
+    const detail::MappedFile file(path);
+    if (!file)
+    {
+        return {};
+    }
+    char delimiter;
+    const auto records = detail::find_records(file.view(), options, &header, delimiter);
+    return detail::group_records(records, delimiter, keyColumn, valueColumns, options, threads);
+}
+
+/// @brief An estimate of the number of distinct values added, in 2^precision bytes (HyperLogLog)
+/// The relative error is about 1.04 / sqrt(2^precision): 1.6% with the default precision.
+class hyperloglog
+{
+public:
+    explicit hyperloglog(unsigned precision = 12)
+        : precision(std::min(18u, std::max(4u, precision))), registers(size_t(1) << this->precision)
+    {
+    }
+
+    /// @brief Adds a value by its 64-bit hash
+    void add(uint64_t hash)
+    {
+        const auto index = hash >> (64 - precision);
+        const auto rest = (hash << precision) | (uint64_t(1) << (precision - 1));
+        registers[index] = std::max(registers[index], static_cast<uint8_t>(detail::leading_zeroes(rest) + 1));
+    }
+
+    void add(std::string_view value)
+    {
+        add(detail::hash_bytes(value));
+    }
+
+    /// @brief Counts the values of other too; both must have the same precision
+    void merge(const hyperloglog& other)
+    {
+        if (other.precision == precision)
+        {
+            for (size_t i = 0; i < registers.size(); ++i)
+            {
+                registers[i] = std::max(registers[i], other.registers[i]);
+            }
+        }
+    }
+
+    double estimate() const
+    {
+        const auto m = static_cast<double>(registers.size());
+        double sum = 0;
+        size_t zeroes = 0;
+        for (const auto rank : registers)
+        {
+            sum += std::ldexp(1.0, -rank);
+            zeroes += rank == 0;
+        }
+        const auto raw = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+        // Small cardinalities are counted better by the registers still empty (linear counting)
+        if (raw <= 2.5 * m && zeroes > 0)
+        {
+            return m * std::log(m / static_cast<double>(zeroes));
+        }
+        return raw;
+    }
+
+private:
+    unsigned precision;
+    std::vector<uint8_t> registers;
+};
+
+/// @brief Approximate quantiles of the numbers added, in memory that grows only with log(count) (KLL sketch)
+/// Level h keeps items standing for 2^h numbers each; a full level is sorted and every other item promoted. The rank
+/// error is about 1.7 / k.
+class kll_sketch
+{
+public:
+    explicit kll_sketch(size_t k = 200) : k(std::max<size_t>(8, k)), levels(1), limit(this->k) { }
+
+    void add(double value)
+    {
+        if (std::isnan(value))
+        {
+            return;
+        }
+        ++n;
+        minimum = std::min(minimum, value);
+        maximum = std::max(maximum, value);
+        levels.front().push_back(value);
+        ++retained;
+        compress();
+    }
+
+    /// @brief Adds the numbers of other too
+    void merge(const kll_sketch& other)
+    {
+        while (levels.size() < other.levels.size())
+        {
+            add_level();
+        }
+        for (size_t h = 0; h < other.levels.size(); ++h)
+        {
+            levels[h].insert(levels[h].end(), other.levels[h].cbegin(), other.levels[h].cend());
+            retained += other.levels[h].size();
+        }
+        n += other.n;
+        minimum = std::min(minimum, other.minimum);
+        maximum = std::max(maximum, other.maximum);
+        compress();
+    }
+
+    /// @brief The number of numbers added
+    size_t count() const
+    {
+        return n;
+    }
+
+    /// @brief The number below which about a fraction q of the numbers lie, or NaN if there are none
+    double quantile(double q) const
+    {
+        if (n == 0)
+        {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        if (q <= 0)
+        {
+            return minimum;
+        }
+        if (q >= 1)
+        {
+            return maximum;
+        }
+        std::vector<std::pair<double, uint64_t>> items;
+        items.reserve(retained);
+        for (size_t h = 0; h < levels.size(); ++h)
+        {
+            for (const auto value : levels[h])
+            {
+                items.emplace_back(value, uint64_t(1) << h);
+            }
+        }
+        std::sort(items.begin(), items.end());
+        const auto target = q * static_cast<double>(n);
+        uint64_t weight = 0;
+        for (const auto& [value, itemWeight] : items)
+        {
+            weight += itemWeight;
+            if (static_cast<double>(weight) >= target)
+            {
+                return std::min(maximum, std::max(minimum, value));
+            }
+        }
+        return maximum;
+    }
+
+    double min() const
+    {
+        return n > 0 ? minimum : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    double max() const
+    {
+        return n > 0 ? maximum : std::numeric_limits<double>::quiet_NaN();
+    }
+
+private:
+    /// @brief Levels below the top get geometrically smaller, by 2/3 per level
+    size_t capacity(size_t level) const
+    {
+        const auto depth = static_cast<int>(levels.size() - 1 - level);
+        return std::max<size_t>(2, static_cast<size_t>(std::ceil(static_cast<double>(k) * std::pow(2.0 / 3, depth))));
+    }
+
+    void add_level()
+    {
+        levels.emplace_back();
+        limit = 0;
+        for (size_t h = 0; h < levels.size(); ++h)
+        {
+            limit += capacity(h);
+        }
+    }
+
+    /// @brief Compacts the lowest full level until the sketch fits
+    void compress()
+    {
+        while (retained > limit)
+        {
+            size_t h = 0;
+            while (levels[h].size() < capacity(h))
+            {
+                ++h;
+            }
+            compact(h);
+        }
+    }
+
+    /// @brief Promotes every other item of a level, from a random first one, keeping an odd one out in place
+    void compact(size_t h)
+    {
+        if (h + 1 == levels.size())
+        {
+            add_level();
+        }
+        auto& level = levels[h];
+        std::sort(level.begin(), level.end());
+        const auto odd = level.size() % 2 != 0;
+        const auto kept = odd ? level.back() : 0.0;
+        const auto even = level.size() - odd;
+        // splitmix64
+        random += 0x9E3779B97F4A7C15;
+        auto bits = (random ^ (random >> 30)) * 0xBF58476D1CE4E5B9;
+        bits = (bits ^ (bits >> 27)) * 0x94D049BB133111EB;
+        for (auto i = static_cast<size_t>((bits ^ (bits >> 31)) & 1); i < even; i += 2)
+        {
+            levels[h + 1].push_back(level[i]);
+        }
+        retained -= even / 2;
+        level.clear();
+        if (odd)
+        {
+            level.push_back(kept);
+        }
+    }
+
+    size_t k;
+    std::vector<std::vector<double>> levels;
+    size_t limit;
+    size_t retained = 0;
+    size_t n = 0;
+    double minimum = std::numeric_limits<double>::infinity();
+    double maximum = -std::numeric_limits<double>::infinity();
+    uint64_t random = 0;
+};
+
+/// @brief Distinct values and quantiles of a column, estimated in a bounded amount of memory
+struct column_sketch
+{
+    hyperloglog distinct; ///< of the non-null fields, compared as text
+    kll_sketch quantiles; ///< of the fields that are numbers
+    size_t nulls = 0;
+
+    void merge(const column_sketch& other)
+    {
+        distinct.merge(other.distinct);
+        quantiles.merge(other.quantiles);
+        nulls += other.nulls;
+    }
+};
+
+namespace detail
+{
+
+/// @brief Adds a field to the sketches of its column
+inline void add_to_sketch(column_sketch& sketch, std::string_view field, char quote)
+{
+    field = strip_quotes(field, quote);
+    double value;
+    if (is_null(field))
+    {
+        ++sketch.nulls;
+        return;
+    }
+    sketch.distinct.add(field);
+    if (parse_float(field.data(), field.data() + field.size(), value))
+    {
+        sketch.quantiles.add(value);
+    }
+}
+} // namespace detail
+
+/// @brief Estimates the distinct values and quantiles of the given columns, or of all of them if none are given, in
+/// one pass that stores no rows
+/// Like aggregate(), ranges of the memory-mapped file are sketched in parallel and the sketches merged.
+/// @return A sketch per column, in the order asked for
+inline std::vector<column_sketch> sketch(std::string_view path,
+                                         const std::vector<size_t>& columns = {},
+                                         const read_options& options = {},
+                                         size_t threads = 0)
+{
+    const detail::MappedFile file(path);
+    if (!file)
+    {
+        return {};
+    }
+    char delimiter;
+    const auto records = detail::find_records(file.view(), options, nullptr, delimiter);
+    return detail::summarize<column_sketch>(records, delimiter, columns, options, threads, detail::add_to_sketch);
+}
+
+/// @brief Estimates the distinct values and quantiles of the given columns after the header, which is read into
+/// header
+inline std::vector<column_sketch> sketch(std::string_view path,
+                                         std::vector<std::string>& header,
+                                         const std::vector<size_t>& columns = {},
+                                         const read_options& options = {},
+                                         size_t threads = 0)
+{
+    const detail::MappedFile file(path);
+    if (!file)
+    {
+        return {};
+    }
+    char delimiter;
+    const auto records = detail::find_records(file.view(), options, &header, delimiter);
+    return detail::summarize<column_sketch>(records, delimiter, columns, options, threads, detail::add_to_sketch);
+}
+
+/// @brief Settings of sort_file()
+struct sort_options
+{
+    size_t memoryBudget = size_t(1) << 30; ///< bytes of records sorted in memory at once, over all threads
+    size_t threads = 0;                    ///< run sorting threads, 0 for one per hardware thread
+    bool descending = false;
+    bool header = true;                    ///< copy the first record to the output ahead of the sorted ones
+    std::string tempDirectory;             ///< where sorted runs are spilled, the output's directory if empty
+};
+
+namespace detail
+{
+
+/// @brief A record and its sort key: a number encoded to compare as unsigned, or else text
+struct SortEntry
+{
+    bool null = false; ///< set for keys that are missing or not of the type sorted by, which sort first
+    uint64_t number = 0;
+    std::string_view text;
+    std::string_view record;
+};
+
+inline bool sort_before(const SortEntry& a, const SortEntry& b, bool descending)
+{
+    if (descending)
+    {
+        return sort_before(b, a, false);
+    }
+    if (a.null != b.null)
+    {
+        return a.null;
+    }
+    return a.number != b.number ? a.number < b.number : a.text < b.text;
+}
+
+/// @brief The contents of a field, unquoted into copies only if it holds escaped quotes
+inline std::string_view field_text(std::string_view field, char quote, std::deque<std::string>& copies)
+{
+    const auto text = strip_quotes(field, quote);
+    return text.size() + 2 < field.size() ? copies.emplace_back(unquote(field, quote)) : text;
+}
+
+/// @brief The line break that ends the first line of text: "\r\n" if it is one with options.lineBreak '\n'
+inline std::string_view line_end(std::string_view text, const read_options& options)
+{
+    const auto lineBreak = text.find(options.lineBreak);
+    if (options.lineBreak == '\n' && lineBreak != text.npos && lineBreak > 0 && text[lineBreak - 1] == '\r')
+    {
+        return "\r\n";
+    }
+    return options.lineBreak == '\n' ? "\n" : std::string_view(&options.lineBreak, 1);
+}
+
+/// @brief Takes the first record off text
+inline std::string_view take_record(std::string_view& text, const read_options& options)
+{
+    std::string_view first;
+    size_t end = 0;
+    for_each_record(text, options, 1, [&](std::string_view record)
+    {
+        first = record;
+        end = record_end(text, record, options.lineBreak);
+    });
+    text.remove_prefix(end);
+    return first;
+}
+
+/// @brief Sets the key of entry from field; text keys with escaped quotes are unquoted into copies
+inline void make_sort_key(SortEntry& entry, std::string_view field, column_type type, char quote,
+                          std::deque<std::string>& copies)
+{
+    if (type == column_type::string)
+    {
+        entry.text = field_text(field, quote, copies);
+        return;
+    }
+    field = strip_quotes(field, quote);
+    const auto first = field.data(), last = field.data() + field.size();
+    constexpr auto signBit = uint64_t(1) << 63;
+    bool boolean;
+    int64_t integer;
+    double floating;
+    std::chrono::system_clock::time_point date;
+    switch (type)
+    {
+        case column_type::boolean:
+            entry.null = !parse_bool(first, last, boolean);
+            entry.number = boolean;
+            break;
+        case column_type::integer:
+            entry.null = !parse_integer(first, last, integer);
+            entry.number = static_cast<uint64_t>(integer) ^ signBit;
+            break;
+        case column_type::floating:
+            entry.null = !parse_float(first, last, floating) || std::isnan(floating);
+            std::memcpy(&entry.number, &floating, sizeof floating);
+            // Negative numbers compare reversed as unsigned, positive ones after them
+            entry.number = entry.number & signBit ? ~entry.number : entry.number | signBit;
+            break;
+        default:
+            entry.null = !parse_date(field, date);
+            entry.number = static_cast<uint64_t>(date.time_since_epoch().count()) ^ signBit;
+            break;
+    }
+}
+
+/// @brief Writes sorted entries to a run file: for each, the null flag, the number, and the text and the record
+/// after their sizes
+inline bool write_run(const std::string& path, const std::vector<SortEntry>& entries)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    std::string buffer;
+    const auto put = [&buffer](const auto& value)
+    {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof value);
+    };
+    for (const auto& entry : entries)
+    {
+        put(static_cast<uint8_t>(entry.null));
+        put(entry.number);
+        put(static_cast<uint64_t>(entry.text.size()));
+        buffer += entry.text;
+        put(static_cast<uint64_t>(entry.record.size()));
+        buffer += entry.record;
+        if (buffer.size() >= (1 << 20))
+        {
+            file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(file);
+}
+
+/// @brief Reads back the entries of a run file in order; the current entry refers to the reader's own strings, so
+/// readers are not moved
+class RunReader
+{
+public:
+    /// @param maxBufferSize bytes read at a time at most; a smaller run is read in one go
+    RunReader(const std::string& path, size_t maxBufferSize)
+    {
+        std::error_code error;
+        const auto fileSize = std::filesystem::file_size(path, error);
+        const auto runSize = error ? maxBufferSize : std::min<uint64_t>(fileSize, maxBufferSize);
+        const auto bufferSize = std::max<size_t>(1, static_cast<size_t>(runSize));
+        buffer.reset(new char[bufferSize]);
+        file.rdbuf()->pubsetbuf(buffer.get(), static_cast<std::streamsize>(bufferSize));
+        file.open(path, std::ios::binary);
+    }
+
+    /// @return false at the end of the run
+    bool next()
+    {
+        uint8_t null;
+        uint64_t size;
+        if (!get(null) || !get(entry.number) || !get(size))
+        {
+            return false;
+        }
+        text.resize(size);
+        file.read(text.data(), static_cast<std::streamsize>(size));
+        get(size);
+        record.resize(size);
+        file.read(record.data(), static_cast<std::streamsize>(size));
+        entry.null = null != 0;
+        entry.text = text;
+        entry.record = record;
+        return static_cast<bool>(file);
+    }
+
+    const SortEntry& current() const
+    {
+        return entry;
+    }
+
+private:
+    template<typename T>
+    bool get(T& value)
+    {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof value));
+    }
+
+    std::unique_ptr<char[]> buffer; ///< left uninitialized, unlike a vector
+    std::ifstream file;
+    std::string text;
+    std::string record;
+    SortEntry entry;
+};
+
+/// @brief Writes the records of the runs to output in order, taking equal keys from earlier runs first
+inline bool merge_runs(std::deque<RunReader>& runs, std::ofstream& output, bool descending, std::string_view lineEnd)
+{
+    // A heap of the runs by their current entries, earliest on top
+    const auto later = [&runs, descending](size_t a, size_t b)
+    {
+        const auto& x = runs[a].current();
+        const auto& y = runs[b].current();
+        return sort_before(y, x, descending) || (!sort_before(x, y, descending) && a > b);
+    };
+    std::vector<size_t> heap;
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        if (runs[i].next())
+        {
+            heap.push_back(i);
+        }
+    }
+    std::make_heap(heap.begin(), heap.end(), later);
+    std::string buffer;
+    while (!heap.empty())
+    {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        auto& run = runs[heap.back()];
+        buffer += run.current().record;
+        buffer += lineEnd;
+        if (buffer.size() >= (1 << 20))
+        {
+            output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+        if (run.next())
+        {
+            std::push_heap(heap.begin(), heap.end(), later);
+        }
+        else
+        {
+            heap.pop_back();
+        }
+    }
+    output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(output);
+}
+
+/// @brief Sorts the records of text into runs of about a thread's share of the memory budget, spilled next to
+/// output, then merges the runs into output after header, ending each record with lineEnd
+inline bool sort_records(std::string_view text,
+                         std::string_view header,
+                         std::string_view lineEnd,
+                         std::string_view output,
+                         char delimiter,
+                         size_t keyColumn,
+                         column_type type,
+                         const read_options& options,
+                         const sort_options& sortOptions)
+{
+    const auto nThreads = thread_count(sortOptions.threads);
+    const auto parallel = options.maxRows == std::numeric_limits<size_t>::max() && options.quote == '"'
+                          && options.lineBreak == '\n';
+    const auto ranges = split_records(text, parallel ? nThreads * 4 : 1, nThreads);
+    const auto runBytes = std::max<size_t>(1 << 16, sortOptions.memoryBudget / nThreads);
+    const std::filesystem::path outputPath(output);
+    const auto runPrefix = (sortOptions.tempDirectory.empty() ? outputPath.parent_path()
+                                                              : std::filesystem::path(sortOptions.tempDirectory))
+                           / (outputPath.filename().string() + ".run");
+    std::vector<std::vector<std::string>> runPaths(ranges.size());
+    std::atomic<bool> failed{false};
+    with_dialect(delimiter, options, [&](const auto& dialect)
+    {
+        parallel_for(ranges.size(), nThreads, [&](size_t i)
+        {
+            std::vector<SortEntry> entries;
+            std::deque<std::string> copies;
+            size_t bytes = 0;
+            const auto spill = [&]
+            {
+                std::stable_sort(entries.begin(), entries.end(), [&sortOptions](const auto& a, const auto& b)
+                {
+                    return sort_before(a, b, sortOptions.descending);
+                });
+                auto path = runPrefix.string() + std::to_string(i) + '.' + std::to_string(runPaths[i].size());
+                runPaths[i].push_back(std::move(path));
+                if (!write_run(runPaths[i].back(), entries))
+                {
+                    failed = true;
+                }
+                entries.clear();
+                copies.clear();
+                bytes = 0;
+            };
+            for_each_record(ranges[i], options, options.maxRows, [&](std::string_view record)
+            {
+                if (record.empty() || (options.filter && !keep_record(record, dialect, options)))
+                {
+                    return false;
+                }
+                auto& entry = entries.emplace_back();
+                entry.record = record;
+                RecordCursor row{record};
+                std::string_view field;
+                while (row.column <= keyColumn && !row.end)
+                {
+                    field = next_field(row, dialect);
+                }
+                entry.null = row.column <= keyColumn;
+                if (!entry.null)
+                {
+                    make_sort_key(entry, field, type, dialect.quote, copies);
+                }
+                bytes += record.size() + sizeof(SortEntry);
+                if (bytes >= runBytes)
+                {
+                    spill();
+                }
+                return true;
+            });
+            if (!entries.empty())
+            {
+                spill();
+            }
+        });
+    });
+
+    std::deque<RunReader> runs;
+    size_t nRuns = 0;
+    for (const auto& paths : runPaths)
+    {
+        nRuns += paths.size();
+    }
+    for (const auto& paths : runPaths)
+    {
+        for (const auto& path : paths)
+        {
+            runs.emplace_back(path, std::clamp<size_t>(sortOptions.memoryBudget / std::max<size_t>(1, nRuns), 1 << 16,
+                                                       1 << 20));
+        }
+    }
+    auto file = std::ofstream(std::string(output), std::ios::binary);
+    if (!header.empty())
+    {
+        file << header << lineEnd;
+    }
+    const auto merged = !failed && file && merge_runs(runs, file, sortOptions.descending, lineEnd);
+    runs.clear();
+    for (const auto& paths : runPaths)
+    {
+        for (const auto& path : paths)
+        {
+            std::error_code error;
+            std::filesystem::remove(path, error);
+        }
+    }
+    return merged;
+}
+} // namespace detail
+
+/// @brief Sorts the records of a file that may not fit in memory by a column read as type, writing them to output
+/// Ranges of the memory-mapped input are parsed and sorted in parallel into runs that fit the memory budget, which
+/// are spilled to temporary binary files and merged. The sort is stable; keys that are missing or not of the type
+/// sort first (last if descending). Records are copied as they are, each ended by the line break that ends the first
+/// line of the input, so a file of "\r\n" lines keeps them; blank lines are dropped.
+/// @return false if the input could not be read or the output or the runs could not be written
+inline bool sort_file(std::string_view input,
+                      std::string_view output,
+                      size_t keyColumn,
+                      column_type type,
+                      const read_options& options = {},
+                      const sort_options& sortOptions = {})
+{
+    const detail::MappedFile file(input);
+    if (!file)
+    {
+        return false;
+    }
+    char delimiter;
+    auto records = detail::find_records(file.view(), options, nullptr, delimiter);
+    const auto lineEnd = detail::line_end(records, options);
+    const auto header = sortOptions.header ? detail::take_record(records, options) : std::string_view{};
+    return detail::sort_records(records, header, lineEnd, output, delimiter, keyColumn, type, options, sortOptions);
+}
+
+/// @brief Settings of join() and join_file()
+struct join_options
+{
+    bool header = true;         ///< both files start with a header, which is not joined; join_file() writes both
+    bool keepUnmatched = false; ///< also emit probed records without a match, as a left outer join does
+    size_t threads = 0;         ///< probing threads, 0 for one per hardware thread
+};
+
+namespace detail
+{
+
+/// @brief The records of the build side of a join by the hash of their key, with the records of a key chained in
+/// file order. Keys and records are views of the mapped file; only keys with escaped quotes are copied.
+class JoinTable
+{
+public:
+    void add(std::string_view record, std::string_view key)
+    {
+        entries.push_back({key, record, hash_bytes(key), 0});
+    }
+
+    /// @brief Indexes the records added; called once, after the last of them
+    void build()
+    {
+        size_t nSlots = 16;
+        while (nSlots < entries.size() * 2)
+        {
+            nSlots *= 2;
+        }
+        slots.assign(nSlots, {});
+        const auto mask = nSlots - 1;
+        // Insert from the last record so that each chain ends up in file order
+        for (auto i = entries.size(); i-- > 0;)
+        {
+            auto& entry = entries[i];
+            auto slot = entry.hash & mask;
+            for (; slots[slot].entry != 0; slot = (slot + 1) & mask)
+            {
+                const auto& first = entries[slots[slot].entry - 1];
+                if (first.hash == entry.hash && first.key == entry.key)
+                {
+                    entry.next = slots[slot].entry;
+                    break;
+                }
+            }
+            slots[slot] = {entry.hash, i + 1};
+        }
+    }
+
+    /// @brief Calls function(record) for the records with key, in file order
+    /// @return false if there are none
+    template<typename Function>
+    bool for_each_match(std::string_view key, Function&& function) const
+    {
+        const auto hash = hash_bytes(key);
+        const auto mask = slots.size() - 1;
+        for (auto slot = hash & mask; slots[slot].entry != 0; slot = (slot + 1) & mask)
+        {
+            if (slots[slot].hash != hash || entries[slots[slot].entry - 1].key != key)
+            {
+                continue;
+            }
+            for (auto entry = slots[slot].entry; entry != 0; entry = entries[entry - 1].next)
+            {
+                function(entries[entry - 1].record);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    std::deque<std::string> copies; ///< keys that had escaped quotes
+
+private:
+    struct Entry
+    {
+        std::string_view key;
+        std::string_view record;
+        uint64_t hash;
+        size_t next; ///< index + 1 of the next record with the same key, 0 for none
+    };
+
+    struct Slot
+    {
+        uint64_t hash = 0;
+        size_t entry = 0; ///< index + 1 of the first record with the key, 0 for an empty slot
+    };
+
+    std::vector<Entry> entries;
+    std::vector<Slot> slots;
+};
+
+/// @brief How the records of both sides of a join are delimited
+struct JoinShape
+{
+    char probeDelimiter;
+    RuntimeDialect build;
+    size_t buildColumns; ///< fields of the first build record
+};
+
+/// @brief Takes the field in column of record, or returns false if the record is too short
+template<typename Dialect>
+bool key_field(std::string_view record, const Dialect& dialect, size_t column, std::string_view& field)
+{
+    RecordCursor row{record};
+    while (row.column <= column && !row.end)
+    {
+        field = next_field(row, dialect);
+    }
+    return row.column > column;
+}
+
+/// @brief Hashes the smaller build file, then streams the probe file through the table in batches of chunks probed
+/// in parallel. match(chunk, probeRecord, buildRecord) collects the joined records of a chunk, with an empty build
+/// record for an unmatched one that is kept; emit(chunk) hands them on and clears the chunk, one chunk at a time and
+/// in file order.
+template<typename ChunkT, typename Headers, typename Match, typename Emit>
+bool join_records(std::string_view probePath,
+                  size_t probeKey,
+                  std::string_view buildPath,
+                  size_t buildKey,
+                  const read_options& options,
+                  const join_options& joinOptions,
+                  Headers&& headers,
+                  Match&& match,
+                  Emit&& emit)
+{
+    const MappedFile probeFile(probePath);
+    const MappedFile buildFile(buildPath);
+    if (!probeFile || !buildFile)
+    {
+        return false;
+    }
+    JoinShape shape{};
+    auto probeText = find_records(probeFile.view(), options, nullptr, shape.probeDelimiter);
+    auto buildText = find_records(buildFile.view(), options, nullptr, shape.build.delimiter);
+    shape.build.quote = options.quote;
+    shape.build.lineBreak = options.lineBreak;
+    const auto probeHeader = joinOptions.header ? take_record(probeText, options) : std::string_view{};
+    const auto buildHeader = joinOptions.header ? take_record(buildText, options) : std::string_view{};
+
+    // Filters and row limits apply to the probed file only
+    JoinTable table;
+    auto buildOptions = options;
+    buildOptions.filter = {};
+    buildOptions.maxRows = std::numeric_limits<size_t>::max();
+    with_dialect(shape.build.delimiter, buildOptions, [&](const auto& dialect)
+    {
+        for_each_record(buildText, buildOptions, buildOptions.maxRows, [&](std::string_view record)
+        {
+            std::string_view field;
+            if (!record.empty() && key_field(record, dialect, buildKey, field))
+            {
+                table.add(record, field_text(field, dialect.quote, table.copies));
+            }
+        });
+    });
+    table.build();
+    const auto firstBuild = joinOptions.header ? buildHeader : take_record(buildText, options);
+    shape.buildColumns = split_record(firstBuild, shape.build).size();
+    headers(shape, probeHeader, buildHeader);
+
+    const auto nThreads = thread_count(joinOptions.threads);
+    const auto parallel = options.maxRows == std::numeric_limits<size_t>::max() && options.quote == '"'
+                          && options.lineBreak == '\n';
+    // Chunks of at most about 16 MB bound what a batch collects before it is emitted
+    const auto ranges = split_records(probeText, parallel ? std::max(nThreads * 4, probeText.size() >> 24) : 1,
+                                      nThreads);
+    std::vector<ChunkT> chunks(std::min(nThreads, ranges.size()));
+    with_dialect(shape.probeDelimiter, options, [&](const auto& dialect)
+    {
+        for (size_t batch = 0; batch < ranges.size(); batch += chunks.size())
+        {
+            const auto nChunks = std::min(chunks.size(), ranges.size() - batch);
+            parallel_for(nChunks, nThreads, [&](size_t i)
+            {
+                std::deque<std::string> copies;
+                for_each_record(ranges[batch + i], options, options.maxRows, [&](std::string_view record)
+                {
+                    if (record.empty() || (options.filter && !keep_record(record, dialect, options)))
+                    {
+                        return false;
+                    }
+                    std::string_view field;
+                    const auto matched = key_field(record, dialect, probeKey, field)
+                                         && table.for_each_match(field_text(field, dialect.quote, copies),
+                                                                 [&](std::string_view buildRecord)
+                                                                 {
+                                                                     match(chunks[i], record, buildRecord);
+                                                                 });
+                    if (!matched && joinOptions.keepUnmatched)
+                    {
+                        match(chunks[i], record, std::string_view{});
+                    }
+                    copies.clear();
+                    // A single chunk is the whole file, so it is emitted as it goes
+                    if (ranges.size() == 1)
+                    {
+                        emit(chunks[i]);
+                    }
+                    return true;
+                });
+            });
+            for (size_t i = 0; i < nChunks; ++i)
+            {
+                emit(chunks[i]);
+            }
+        }
+    });
+    return true;
+}
+
+/// @brief Appends the fields of a build record delimited like the probed records, or empty fields for none
+inline void append_build_fields(std::string& out, std::string_view record, const JoinShape& shape)
+{
+    if (record.empty())
+    {
+        out.append(shape.buildColumns > 0 ? shape.buildColumns - 1 : 0, shape.probeDelimiter);
+        return;
+    }
+    if (shape.build.delimiter == shape.probeDelimiter)
+    {
+        out += record;
+        return;
+    }
+    RecordCursor row{record};
+    while (!row.end)
+    {
+        const auto field = next_field(row, shape.build);
+        // A field holding the new delimiter needs quotes
+        const auto quote = field.find(shape.probeDelimiter) != field.npos && field.front() != shape.build.quote;
+        if (quote)
+        {
+            out += shape.build.quote;
+        }
+        out += field;
+        if (quote)
+        {
+            out += shape.build.quote;
+        }
+        if (!row.end)
+        {
+            out += shape.probeDelimiter;
+        }
+    }
+}
+} // namespace detail
+
+/// @brief Calls function(probeRecord, buildRecord) for each pair of records of the two files with equal keys, as
+/// an inner join, or with an empty buildRecord for probed records without a match if joinOptions.keepUnmatched
+/// The build file, the smaller one, is hashed by its key column; the probe file is never loaded but streamed through
+/// the table in chunks probed in parallel. function is called from one thread at a time, in probe file order, with
+/// the records as they are in the files.
+/// @return false if a file could not be read
+template<typename Function>
+bool join(std::string_view probePath,
+          size_t probeKey,
+          std::string_view buildPath,
+          size_t buildKey,
+          Function&& function,
+          const read_options& options = {},
+          const join_options& joinOptions = {})
+{
+    using Matches = std::vector<std::pair<std::string_view, std::string_view>>;
+    return detail::join_records<Matches>(
+            probePath, probeKey, buildPath, buildKey, options, joinOptions,
+            [](const detail::JoinShape&, std::string_view, std::string_view) { },
+            [](Matches& matches, std::string_view probeRecord, std::string_view buildRecord)
+            {
+                matches.emplace_back(probeRecord, buildRecord);
+            },
+            [&function](Matches& matches)
+            {
+                for (const auto& [probeRecord, buildRecord] : matches)
+                {
+                    function(probeRecord, buildRecord);
+                }
+                matches.clear();
+            });
+}
+
+/// @brief Writes each probed record followed by the fields of the build records with an equal key, and the two
+/// headers the same way, as join() pairs them; rows are formatted in parallel and written in probe file order
+/// @return false if a file could not be read or the output could not be written
+inline bool join_file(std::string_view probePath,
+                      size_t probeKey,
+                      std::string_view buildPath,
+                      size_t buildKey,
+                      std::string_view outputPath,
+                      const read_options& options = {},
+                      const join_options& joinOptions = {})
+{
+    auto output = std::ofstream(std::string(outputPath), std::ios::binary);
+    detail::JoinShape shape{};
+    const auto joinRecords = [&](std::string& out, std::string_view probeRecord, std::string_view buildRecord)
+    {
+        out += probeRecord;
+        out += shape.probeDelimiter;
+        detail::append_build_fields(out, buildRecord, shape);
+        out += options.lineBreak;
+    };
+    const auto joined = output && detail::join_records<std::string>(
+            probePath, probeKey, buildPath, buildKey, options, joinOptions,
+            [&](const detail::JoinShape& joinShape, std::string_view probeHeader, std::string_view buildHeader)
+            {
+                shape = joinShape;
+                if (joinOptions.header)
+                {
+                    std::string line;
+                    joinRecords(line, probeHeader, buildHeader);
+                    output << line;
+                }
+            },
+            joinRecords,
+            [&output](std::string& out)
+            {
+                if (!out.empty())
+                {
+                    output.write(out.data(), static_cast<std::streamsize>(out.size()));
+                    out.clear();
+                }
+            });
+    return joined && static_cast<bool>(output);
+}
+
+/// @brief Settings of for_each_row()
+struct pipeline_options
+{
+    size_t parseThreads = 0;            ///< 0 for one per hardware thread
+    size_t queueDepth = 4;              ///< blocks that may wait for each parse thread, read or parsed, before the
+                                        ///< stage feeding it sleeps until there is room
+    size_t blockSize = size_t(1) << 20; ///< bytes read at a time, rounded down to whole records
+};
+
+namespace detail
+{
+
+/// @brief A bounded queue between one producing thread and one consuming thread
+/// Values pass without locks. A side that finds the queue full or empty spins for a moment, then sleeps on a
+/// condition variable until the other side changes the queue, so a stalled stage does not keep a core busy.
+template<typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacity) : slots(std::max<size_t>(capacity, 1) + 1) { }
+
+    /// @brief Waits for room for value, unless stop is set
+    /// @return false if stopped
+    bool push(T& value, const std::atomic<bool>& stop)
+    {
+        const auto position = tail.load(std::memory_order_relaxed);
+        const auto next = position + 1 == slots.size() ? 0 : position + 1;
+        if (!wait([&] { return next != head.load(std::memory_order_acquire); }, stop))
+        {
+            return false;
+        }
+        slots[position] = std::move(value);
+        tail.store(next, std::memory_order_release);
+        notify();
+        return true;
+    }
+
+    /// @brief Waits for a value, unless stop is set
+    /// @return false if stopped
+    bool pop(T& value, const std::atomic<bool>& stop)
+    {
+        const auto position = head.load(std::memory_order_relaxed);
+        if (!wait([&] { return position != tail.load(std::memory_order_acquire); }, stop))
+        {
+            return false;
+        }
+        value = std::move(slots[position]);
+        head.store(position + 1 == slots.size() ? 0 : position + 1, std::memory_order_release);
+        notify();
+        return true;
+    }
+
+    /// @brief Wakes a thread waiting on the queue to see that stop has been set
+    void wake()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        changed.notify_all();
+    }
+
+private:
+    /// @brief Spins briefly until ready(), then sleeps until the other side changes the queue or stop is set
+    template<typename Ready>
+    bool wait(Ready ready, const std::atomic<bool>& stop)
+    {
+        for (int spins = 0; spins < 64; ++spins)
+        {
+            if (ready())
+            {
+                return true;
+            }
+            if (stop.load(std::memory_order_relaxed))
+            {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        waiting.fetch_add(1, std::memory_order_relaxed);
+        // Pairs with the fence in notify(): either this sees the change, or notify() sees the waiter
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        changed.wait(lock, [&] { return ready() || stop.load(std::memory_order_relaxed); });
+        waiting.fetch_sub(1, std::memory_order_relaxed);
+        return ready();
+    }
+
+    /// @brief Wakes the other side if it sleeps in wait(); costs an atomic load when it does not
+    void notify()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed) > 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            changed.notify_all();
+        }
+    }
+
+    std::vector<T> slots;
+    alignas(64) std::atomic<size_t> head{0}; ///< next slot to pop, written by the consumer only
+    alignas(64) std::atomic<size_t> tail{0}; ///< next slot to push, written by the producer only
+    alignas(64) std::atomic<int> waiting{0}; ///< threads asleep in wait()
+    std::mutex mutex;
+    std::condition_variable changed;
+};
+
+/// @brief Whole records read from a file, or the end of it
+struct PipelineBlock
+{
+    std::string text;
+    bool last = false;
+};
+
+/// @brief The rows parsed from a block, or the end of the file
+template<typename Row>
+struct PipelineBatch
+{
+    std::vector<Row> rows;
+    bool last = false;
+};
+
+/// @brief Reads blocks of whole records, handing them to the parse threads in turn
+inline void read_blocks(std::istream& file,
+                        const read_options& options,
+                        size_t blockSize,
+                        std::deque<SpscQueue<PipelineBlock>>& queues,
+                        const std::atomic<bool>& stop)
+{
+    std::string carried; // an unfinished record from the end of the last block
+    for (size_t sequence = 0; !stop;)
+    {
+        PipelineBlock block;
+        block.text.resize(carried.size() + blockSize);
+        std::memcpy(block.text.data(), carried.data(), carried.size());
+        file.read(block.text.data() + carried.size(), static_cast<std::streamsize>(blockSize));
+        const auto count = static_cast<size_t>(file.gcount());
+        block.text.resize(carried.size() + count);
+        carried.clear();
+        if (count > 0)
+        {
+            // Cut after the last line break outside quotes; a record longer than the block waits for more
+            const char* first = block.text.data();
+            const char* last = first + block.text.size();
+            const char* cut = nullptr;
+            bool inQuotes = false;
+            for (auto recordEnd = first; (recordEnd = find_record_end(recordEnd, last, inQuotes, options.quote,
+                                                                      options.lineBreak));)
+            {
+                cut = ++recordEnd;
+                inQuotes = false;
+            }
+            const auto size = cut ? static_cast<size_t>(cut - first) : 0;
+            carried.assign(block.text, size);
+            block.text.resize(size);
+            if (block.text.empty())
+            {
+                continue;
+            }
+        }
+        else if (block.text.empty())
+        {
+            break;
+        }
+        if (!queues[sequence++ % queues.size()].push(block, stop))
+        {
+            return;
+        }
+    }
+    for (size_t i = 0; i < queues.size(); ++i)
+    {
+        PipelineBlock end{{}, true};
+        queues[i].push(end, stop);
+    }
+}
+
+/// @brief Parses the records of the blocks in a queue into batches of rows, in the same order
+template<typename RowT, typename Dialect>
+void parse_blocks(const Dialect& dialect,
+                  const read_options& options,
+                  SpscQueue<PipelineBlock>& blocks,
+                  SpscQueue<PipelineBatch<RowOutT<RowT>>>& batches,
+                  const std::atomic<bool>& stop)
+{
+    const auto& prefix = options.commentPrefix;
+    Instrument<false> instrument;
+    for (PipelineBlock block; blocks.pop(block, stop);)
+    {
+        PipelineBatch<RowOutT<RowT>> batch;
+        batch.last = block.last;
+        // At the end of the file, the last record may lack its line break
+        const char* first = block.text.data();
+        const char* last = first + block.text.size();
+        for (auto position = first; position < last;)
+        {
+            bool inQuotes = false;
+            auto recordEnd = find_record_end(position, last, inQuotes, options.quote, options.lineBreak);
+            recordEnd = recordEnd ? recordEnd : last;
+            auto record = std::string_view(position, static_cast<size_t>(recordEnd - position));
+            position = recordEnd + 1;
+            if (options.lineBreak == '\n' && !record.empty() && record.back() == '\r')
+            {
+                record.remove_suffix(1);
+            }
+            if ((!prefix.empty() && record.substr(0, prefix.size()) == prefix)
+                || (options.filter && !keep_record(record, dialect, options)))
+            {
+                continue;
+            }
+            parse_record<RowT>(record, dialect, batch.rows.emplace_back(), instrument);
+        }
+        if (!batches.push(batch, stop) || block.last)
+        {
+            return;
+        }
+    }
+}
+
+/// @brief The reader and parse threads of for_each_row. An exception on one of them stops every stage, and join()
+/// rethrows it on the calling thread; the destructor stops and joins the stages however the consumer stage ends.
+template<typename Batch>
+class PipelineStages
+{
+public:
+    PipelineStages(std::atomic<bool>& stop,
+                   std::deque<SpscQueue<PipelineBlock>>& blocks,
+                   std::deque<SpscQueue<Batch>>& batches)
+        : stop(stop), blocks(blocks), batches(batches) { }
+
+    PipelineStages(const PipelineStages&) = delete;
+    PipelineStages& operator=(const PipelineStages&) = delete;
+
+    ~PipelineStages()
+    {
+        halt();
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    /// @brief Runs stage() on a thread of its own
+    template<typename Stage>
+    void start(Stage stage)
+    {
+        threads.emplace_back([this, stage]() mutable
+        {
+            try
+            {
+                stage();
+            }
+            catch (...)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+                halt();
+            }
+        });
+    }
+
+    /// @brief Stops and joins the stages, then rethrows the first exception thrown on one of them
+    void join()
+    {
+        halt();
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        threads.clear();
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    /// @brief Sets stop and wakes every thread waiting on a queue to see it
+    void halt()
+    {
+        stop = true;
+        for (auto& queue : blocks)
+        {
+            queue.wake();
+        }
+        for (auto& queue : batches)
+        {
+            queue.wake();
+        }
+    }
+
+    std::atomic<bool>& stop;
+    std::deque<SpscQueue<PipelineBlock>>& blocks;
+    std::deque<SpscQueue<Batch>>& batches;
+    std::vector<std::thread> threads;
+    std::mutex errorMutex;
+    std::exception_ptr error; ///< the first exception thrown on a stage
+};
+} // namespace detail
+
+/// @brief Reads a file in three overlapping stages: a thread reads blocks of whole records, parse threads turn them
+/// into rows, and consumer(row) gets the rows in file order on the calling thread
+/// Blocks are dealt to the parse threads in turn and their rows collected in the same turn, so every queue has one
+/// thread at each end and is lock-free. Each queue holds at most queueDepth blocks: a slow consumer holds up the
+/// parsing, and slow parsing holds up the reading. consumer may return false to stop early.
+/// An exception thrown while reading or parsing, such as by a where() predicate, stops every stage and is rethrown
+/// here once they have all been joined; so is one thrown by consumer.
+/// @return false if the file could not be opened
+template<typename RowT, typename Consumer>
+bool for_each_row(std::string_view path,
+                  std::vector<std::string>* header,
+                  Consumer&& consumer,
+                  const read_options& options = {},
+                  const pipeline_options& pipelineOptions = {})
+{
+    auto file = std::ifstream(std::string(path), std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    // Skipped lines, the delimiter and the header are read first, then the stages read on from after them
+    uint64_t start;
+    char delimiter;
+    {
+        detail::Instrument<false> instrument;
+        detail::RecordReader reader(file, options, 1 << 16);
+        reader.skip_lines(options.skipRows, instrument);
+        delimiter = detail::get_delimiter(reader, options.delimiter, instrument);
+        if (std::string_view record; header && reader.next(record, instrument))
+        {
+            *header = detail::parse_record<std::vector<std::string>>(record, detail::RuntimeDialect{
+                    delimiter, options.quote, options.lineBreak});
+        }
+        start = reader.offset();
+    }
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(start));
+
+    using Batch = detail::PipelineBatch<detail::RowOutT<RowT>>;
+    const auto nWorkers = detail::thread_count(pipelineOptions.parseThreads);
+    std::deque<detail::SpscQueue<detail::PipelineBlock>> blocks;
+    std::deque<detail::SpscQueue<Batch>> batches;
+    for (size_t i = 0; i < nWorkers; ++i)
+    {
+        blocks.emplace_back(pipelineOptions.queueDepth);
+        batches.emplace_back(pipelineOptions.queueDepth);
+    }
+    std::atomic<bool> stop{false};
+    detail::with_dialect(delimiter, options, [&](const auto& dialect)
+    {
+        detail::PipelineStages<Batch> stages(stop, blocks, batches);
+        stages.start([&]
+        {
+            detail::read_blocks(file, options, std::max<size_t>(pipelineOptions.blockSize, 1), blocks, stop);
+        });
+        for (size_t i = 0; i < nWorkers; ++i)
+        {
+            stages.start([&, i] { detail::parse_blocks<RowT>(dialect, options, blocks[i], batches[i], stop); });
+        }
+        size_t nRows = 0;
+        for (size_t i = 0; !stop; i = (i + 1) % nWorkers)
+        {
+            Batch batch;
+            if (!batches[i].pop(batch, stop))
+            {
+                break;
+            }
+            for (auto& row : batch.rows)
+            {
+                if (nRows++ == options.maxRows)
+                {
+                    stop = true;
+                    break;
+                }
+                if constexpr (std::is_same_v<decltype(consumer(row)), bool>)
+                {
+                    if (!consumer(row))
+                    {
+                        stop = true;
+                        break;
+                    }
+                }
+                else
+                {
+                    consumer(row);
+                }
+            }
+            if (batch.last)
+            {
+                break;
+            }
+        }
+        stages.join();
+    });
+    return true;
+}
+
+/// @brief Reads a file in pipelined stages as for_each_row(path, header, consumer) does, taking no header
+template<typename RowT, typename Consumer>
+bool for_each_row(std::string_view path,
+                  Consumer&& consumer,
+                  const read_options& options = {},
+                  const pipeline_options& pipelineOptions = {})
+{
+    return for_each_row<RowT>(path, nullptr, std::forward<Consumer>(consumer), options, pipelineOptions);
+}
+
+/// @brief The rows of a file parsed by the threads of one NUMA node, which also allocated them
+template<typename RowT>
+struct partition
+{
+    size_t node = 0; ///< the NUMA node the rows were allocated on, 0 where the topology is unknown
+    std::vector<RowT> rows;
+};
+
+/// @brief Settings of parsing a file on several threads at once
+struct parallel_options
+{
+    size_t threads = 0;     ///< parsing threads, 0 for one per hardware thread
+    bool pinThreads = true; ///< keeps each thread on the CPUs of one NUMA node, so that the rows it parses stay there
+};
+
+namespace detail
+{
+
+/// @brief The CPUs of a NUMA node that this process may run on
+struct NumaNode
+{
+    size_t id = 0;
+    std::vector<int> cpus; ///< empty to leave threads unpinned
+};
+
+/// @brief The CPUs of a list such as "0-3,8,10-11"
+inline std::vector<int> parse_cpu_list(std::string_view text)
+{
+    std::vector<int> cpus;
+    while (!text.empty())
+    {
+        const auto comma = std::min(text.find(','), text.size());
+        const auto range = text.substr(0, comma);
+        text.remove_prefix(std::min(comma + 1, text.size()));
+        const auto end = range.data() + range.size();
+        int first, last;
+        if (std::from_chars(range.data(), end, first).ec != std::errc())
+        {
+            continue;
+        }
+        const auto dash = range.find('-');
+        if (dash == range.npos || std::from_chars(range.data() + dash + 1, end, last).ec != std::errc())
+        {
+            last = first;
+        }
+        for (auto cpu = first; cpu <= last; ++cpu)
+        {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+/// @brief The NUMA nodes with CPUs this process may run on, from /sys on Linux, in order of their ids
+/// Elsewhere, or if the topology cannot be read, there is one node with no CPUs.
+inline std::vector<NumaNode> numa_nodes()
+{
+    std::vector<NumaNode> nodes;
+#if defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    std::error_code error;
+    if (::sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
+    {
+        for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", error))
+        {
+            const auto name = entry.path().filename().string();
+            NumaNode node;
+            if (name.compare(0, 4, "node") != 0
+                || std::from_chars(name.data() + 4, name.data() + name.size(), node.id).ec != std::errc())
+            {
+                continue;
+            }
+            std::string list;
+            std::getline(std::ifstream(entry.path() / "cpulist"), list);
+            for (const auto cpu : parse_cpu_list(list))
+            {
+                if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))
+                {
+                    node.cpus.push_back(cpu);
+                }
+            }
+            if (!node.cpus.empty())
+            {
+                nodes.push_back(std::move(node));
+            }
+        }
+    }
+    std::sort(nodes.begin(), nodes.end(), [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+#endif
+    if (nodes.empty())
+    {
+        nodes.emplace_back();
+    }
+    return nodes;
+}
+
+/// @brief Keeps the calling thread on cpus, if any; on Linux, the threads it starts afterwards inherit them
+inline void pin_thread(const std::vector<int>& cpus)
+{
+#if defined(__linux__)
+    if (!cpus.empty())
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (const auto cpu : cpus)
+        {
+            CPU_SET(cpu, &set);
+        }
+        ::sched_setaffinity(0, sizeof(set), &set);
+    }
+#else
+    static_cast<void>(cpus);
+#endif
+}
+
+/// @brief Parses the records of text that are not comments and pass the filter, up to options.maxRows
+template<typename RowT, typename Dialect>
+std::vector<RowOutT<RowT>> parse_range(std::string_view text, const Dialect& dialect, const read_options& options)
+{
+    std::vector<RowOutT<RowT>> rows;
+    Instrument<false> instrument;
+    for_each_record(text, options, options.maxRows, [&](std::string_view record)
+    {
+        if (options.filter && !keep_record(record, dialect, options))
+        {
+            return false;
+        }
+        parse_record<RowT>(record, dialect, rows.emplace_back(), instrument);
+        return true;
+    });
+    return rows;
+}
+
+/// @brief Parses a memory-mapped file into a partition per NUMA node
+/// Threads are dealt to the nodes in turn, and each node parses a run of ranges of whole records in proportion to
+/// its threads. A pinned thread per node starts the node's other threads, which inherit its CPUs; each range is
+/// parsed into a vector of its own, so the pages of the rows are first touched, and allocated, on the node. The
+/// node's first thread then gathers its ranges into the partition, again on the node.
+template<typename RowT>
+std::vector<partition<RowOutT<RowT>>> parse_partitions(std::string_view path,
+                                                       std::vector<std::string>* header,
+                                                       const read_options& options,
+                                                       const parallel_options& parallelOptions)
+{
+    using Row = RowOutT<RowT>;
+    const MappedFile file(path);
+    if (!file)
+    {
+        return {};
+    }
+    char delimiter;
+    const auto records = find_records(file.view(), options, header, delimiter);
+
+    const auto nThreads = thread_count(parallelOptions.threads);
+    const auto parallel = options.maxRows == std::numeric_limits<size_t>::max() && options.quote == '"'
+                          && options.lineBreak == '\n';
+    const auto ranges = split_records(records, parallel ? nThreads * 4 : 1, nThreads);
+    auto nodes = parallelOptions.pinThreads ? numa_nodes() : std::vector<NumaNode>(1);
+    nodes.resize(std::min({nodes.size(), nThreads, ranges.size()}));
+
+    std::vector<partition<Row>> partitions(nodes.size());
+    std::vector<std::vector<Row>> chunks(ranges.size());
+    with_dialect(delimiter, options, [&](const auto& dialect)
+    {
+        std::vector<std::thread> threads;
+        for (size_t n = 0, threadsBefore = 0; n < nodes.size(); ++n)
+        {
+            const auto nodeThreads = nThreads / nodes.size() + (n < nThreads % nodes.size() ? 1 : 0);
+            const auto first = ranges.size() * threadsBefore / nThreads;
+            threadsBefore += nodeThreads;
+            const auto last = ranges.size() * threadsBefore / nThreads;
+            threads.emplace_back([&, n, nodeThreads, first, last]
+            {
+                pin_thread(nodes[n].cpus);
+                parallel_for(last - first, nodeThreads, [&](size_t i)
+                {
+                    chunks[first + i] = parse_range<RowT>(ranges[first + i], dialect, options);
+                });
+                auto& rows = partitions[n].rows;
+                partitions[n].node = nodes[n].id;
+                if (last - first == 1)
+                {
+                    rows = std::move(chunks[first]);
+                    return;
+                }
+                size_t nRows = 0;
+                for (auto i = first; i < last; ++i)
+                {
+                    nRows += chunks[i].size();
+                }
+                rows.reserve(nRows);
+                for (auto i = first; i < last; ++i)
+                {
+                    rows.insert(rows.end(), std::make_move_iterator(chunks[i].begin()),
+                                std::make_move_iterator(chunks[i].end()));
+                    std::vector<Row>().swap(chunks[i]);
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    });
+    return partitions;
+}
+} // namespace detail
+
+/// @brief Parses a file on several threads into a partition of rows per NUMA node, in file order
+/// Each partition holds a run of consecutive rows that were parsed and allocated by threads pinned to its node, so
+/// consumers running on that node read them without crossing sockets. The partitions follow each other in the file;
+/// a file with a row limit, or a dialect other than '"' and '\n', is parsed into one.
+/// @param header gets the fields of the first record after the skipped lines, if not null
+/// @return No partitions if the file could not be read
+template<typename... ColumnTs>
+std::vector<partition<FilteredTuple<ColumnTs...>>> to_partitions(std::string_view path,
+                                                                 std::vector<std::string>* header = nullptr,
+                                                                 const read_options& options = {},
+                                                                 const parallel_options& parallelOptions = {})
+{
+    return detail::parse_partitions<std::tuple<ColumnTs...>>(path, header, options, parallelOptions);
+}
+
+/// @brief Parses a file on several threads into one vector of rows, as to_partitions() does and then concatenated
+/// The rows are moved into the vector by the calling thread, so they are no longer local to the nodes that parsed
+/// them; take the partitions instead where that matters.
+template<typename... ColumnTs>
+std::vector<FilteredTuple<ColumnTs...>> to_tuples(std::string_view path,
+                                                  std::vector<std::string>* header,
+                                                  const read_options& options,
+                                                  const parallel_options& parallelOptions)
+{
+    auto partitions = to_partitions<ColumnTs...>(path, header, options, parallelOptions);
+    if (partitions.empty())
+    {
+        return {};
+    }
+    size_t nRows = 0;
+    for (const auto& part : partitions)
+    {
+        nRows += part.rows.size();
+    }
+    auto rows = std::move(partitions.front().rows);
+    rows.reserve(nRows);
+    for (size_t i = 1; i < partitions.size(); ++i)
+    {
+        rows.insert(rows.end(), std::make_move_iterator(partitions[i].rows.begin()),
+                    std::make_move_iterator(partitions[i].rows.end()));
+    }
+    return rows;
 }
 
 } // namespace csv
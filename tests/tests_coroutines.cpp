@@ -0,0 +1,205 @@
+//
+// Tests of the coroutine API, which needs C++20.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "csv.hpp"
+
+#include "catch.hpp"
+#include <filesystem>
+#include <stdexcept>
+
+namespace
+{
+
+/// @brief A coroutine that starts at once and is not waited for
+struct Task
+{
+    struct promise_type
+    {
+        Task get_return_object()
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void() { }
+
+        void unhandled_exception()
+        {
+            std::terminate();
+        }
+    };
+};
+
+/// @brief Runs the coroutines posted to it on the thread that calls run()
+class EventLoop
+{
+public:
+    void post(std::coroutine_handle<> coroutine)
+    {
+        // Notified under the lock, as the loop may finish and go away as soon as it is released
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.push_back(coroutine);
+        wakeUp.notify_one();
+    }
+
+    /// @brief Resumes coroutines until nRunning of them have finished
+    void run(const size_t& nRunning)
+    {
+        while (nRunning > 0)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeUp.wait(lock, [this] { return !ready.empty(); });
+            const auto coroutine = ready.front();
+            ready.pop_front();
+            lock.unlock();
+            coroutine.resume();
+        }
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::deque<std::coroutine_handle<>> ready;
+};
+} // namespace
+
+TEST_CASE("Row generator")
+{
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_generator.csv";
+    std::vector<std::tuple<int, std::string, double>> rows;
+    for (int i = 0; i < 20000; ++i)
+    {
+        rows.emplace_back(i, i % 5 == 0 ? "spans\nlines" : "plain", i * 0.25);
+    }
+    REQUIRE(csv::write(csvPath.string(), rows, std::array<std::string, 3>{"id", "text", "value"}));
+
+    size_t i = 0;
+    for (const auto& row : csv::rows<int, std::string, double>(csvPath.string(), {}, true))
+    {
+        REQUIRE(i < rows.size());
+        CHECK(row == rows[i++]);
+    }
+    CHECK(i == rows.size());
+
+    size_t nIds = 0;
+    for (const auto& [id] : csv::rows<int, csv::ignore, csv::ignore>(csvPath.string(), {}, true))
+    {
+        nIds += id == static_cast<int>(nIds);
+    }
+    CHECK(nIds == rows.size());
+
+    std::filesystem::remove(csvPath);
+}
+
+TEST_CASE("Async readers on one thread")
+{
+    constexpr size_t nFiles = 3;
+    std::vector<std::filesystem::path> paths;
+    for (size_t file = 0; file < nFiles; ++file)
+    {
+        paths.push_back(std::filesystem::temp_directory_path() / ("std_csv_async" + std::to_string(file) + ".csv"));
+        std::vector<std::tuple<int, std::string>> rows;
+        for (int i = 0; i < 30000; ++i)
+        {
+            rows.emplace_back(i, "row \"" + std::to_string(i) + "\",\nof file " + std::to_string(file));
+        }
+        REQUIRE(csv::write(paths.back().string(), rows, std::array<std::string, 2>{"id", "text"}));
+    }
+
+    EventLoop loop;
+    const auto loopThread = std::this_thread::get_id();
+    std::vector<size_t> nRows(nFiles);
+    std::vector<char> inOrder(nFiles, true);
+    std::vector<std::string> headers(nFiles);
+    size_t nRunning = nFiles;
+    const auto readFile = [&](size_t file) -> Task
+    {
+        // Small blocks, so the readers take turns many times
+        csv::async_reader<std::tuple<int, std::string>> reader(
+                paths[file].string(), {}, true, [&loop](std::coroutine_handle<> coroutine) { loop.post(coroutine); },
+                1 << 12);
+        for (std::tuple<int, std::string> row; co_await reader.next(row);)
+        {
+            const auto expected = "row \"" + std::to_string(nRows[file]) + "\",\nof file " + std::to_string(file);
+            inOrder[file] = inOrder[file] && std::get<0>(row) == static_cast<int>(nRows[file])
+                            && std::get<1>(row) == expected && std::this_thread::get_id() == loopThread;
+            ++nRows[file];
+        }
+        headers[file] = reader.header().empty() ? "" : reader.header().back();
+        --nRunning;
+    };
+    for (size_t file = 0; file < nFiles; ++file)
+    {
+        readFile(file);
+    }
+    loop.run(nRunning);
+
+    for (size_t file = 0; file < nFiles; ++file)
+    {
+        CHECK(nRows[file] == 30000);
+        CHECK(inOrder[file]);
+        CHECK(headers[file] == "text");
+        std::filesystem::remove(paths[file]);
+    }
+}
+
+TEST_CASE("Async reader exceptions")
+{
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_async_throw.csv";
+    std::vector<std::tuple<int>> rows;
+    for (int i = 0; i < 10000; ++i)
+    {
+        rows.emplace_back(i);
+    }
+    REQUIRE(csv::write(csvPath.string(), rows));
+
+    // The filter throws on the background thread; the exception comes out of co_await in the coroutine
+    csv::read_options options;
+    options.where(0, [](std::string_view field)
+    {
+        if (field == "5000")
+        {
+            throw std::runtime_error("bad row");
+        }
+        return true;
+    });
+    EventLoop loop;
+    size_t nRows = 0;
+    std::string message;
+    size_t nRunning = 1;
+    const auto read = [&]() -> Task
+    {
+        csv::async_reader<std::tuple<int>> reader(
+                csvPath.string(), options, false, [&loop](std::coroutine_handle<> coroutine) { loop.post(coroutine); },
+                1 << 12);
+        try
+        {
+            for (std::tuple<int> row; co_await reader.next(row);)
+            {
+                ++nRows;
+            }
+        }
+        catch (const std::runtime_error& error)
+        {
+            message = error.what();
+        }
+        --nRunning;
+    };
+    read();
+    loop.run(nRunning);
+    CHECK(message == "bad row");
+    CHECK(nRows == 5000);
+    std::filesystem::remove(csvPath);
+}
@@ -7,7 +7,14 @@
 #include "csv.hpp"
 
 #include "catch.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <filesystem>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <thread>
 
 const auto dataDir = std::filesystem::path(STDCSV_PROJECT_DIR) / "data";
 
@@ -117,3 +124,1069 @@ TEST_CASE("Tab delimiter deduction")
     CHECK(std::get<4>(t) == 9);
     CHECK(std::get<5>(t) == -9999);
 }
+
+TEST_CASE("Write and read back")
+{
+    const auto outPath = std::filesystem::temp_directory_path() / "std_csv_write.csv";
+
+    SECTION("tuples")
+    {
+        const auto rows = std::vector<std::tuple<int, double, bool, std::string>>{
+                {1, 2.01, true, "plain"},
+                {-3, 0.1, false, "with, delimiter"},
+                {42, -1e300, true, "with \"quotes\"\nand a line break"}
+        };
+        REQUIRE(csv::write(outPath.string(), rows, std::array<std::string, 4>{"a", "b", "c", "d"}));
+
+        std::array<std::string, 4> header;
+        CHECK(csv::to_tuples<int, double, bool, std::string>(outPath.string(), header) == rows);
+        CHECK(header == std::array<std::string, 4>{"a", "b", "c", "d"});
+    }
+
+    SECTION("arrays and vectors")
+    {
+        const auto arrays = std::vector<std::array<float, 3>>{{1.5f, -2.25f, 3.f}, {0.1f, 1e-20f, 7.f}};
+        REQUIRE(csv::write(outPath.string(), arrays, {'\t'}));
+        CHECK(csv::to_arrays<float, 3>(outPath.string()) == arrays);
+
+        const auto vectors = std::vector<std::vector<long>>{{1, 2}, {-9999, 1234567890123}};
+        REQUIRE(csv::write(outPath.string(), vectors));
+        CHECK(csv::to_vectors<long>(outPath.string()) == vectors);
+    }
+
+    SECTION("characters")
+    {
+        const auto rows = std::vector<std::tuple<char, unsigned char, int>>{{'a', 'b', 1}, {',', 'z', 2}};
+        REQUIRE(csv::write(outPath.string(), rows));
+        std::ifstream file(outPath, std::ios::binary);
+        CHECK(std::string(std::istreambuf_iterator<char>(file), {}) == "a,b,1\n\",\",z,2\n");
+        file.close();
+        CHECK(csv::to_tuples<char, unsigned char, int>(outPath.string()) == rows);
+    }
+
+    SECTION("parallel output matches serial output")
+    {
+        std::vector<std::vector<int>> rows(100000, std::vector<int>(4));
+        for (size_t i = 0; i < rows.size(); ++i)
+        {
+            rows[i] = {static_cast<int>(i), static_cast<int>(i * 7), -static_cast<int>(i), 3};
+        }
+        const auto read = [](const std::filesystem::path& path)
+        {
+            std::ifstream file(path, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(file), {});
+        };
+
+        REQUIRE(csv::write(outPath.string(), rows));
+        const auto serial = read(outPath);
+        csv::write_options options;
+        options.threads = 4;
+        REQUIRE(csv::write(outPath.string(), rows, options));
+        CHECK(read(outPath) == serial);
+        CHECK(csv::to_vectors<int>(outPath.string()) == rows);
+    }
+
+    std::filesystem::remove(outPath);
+}
+
+TEST_CASE("Written floats are shortest and round-trip exactly")
+{
+    const auto outPath = std::filesystem::temp_directory_path() / "std_csv_write_float.csv";
+
+    REQUIRE(csv::write(outPath.string(), std::vector<std::array<double, 3>>{{0.1, 1e23, -2.5}}));
+    std::ifstream file(outPath);
+    std::string line;
+    std::getline(file, line);
+    CHECK(line == "0.1,1e+23,-2.5");
+    file.close();
+
+    std::mt19937_64 random(2020);
+    std::vector<std::vector<double>> rows(1000, std::vector<double>(8));
+    for (auto& row : rows)
+    {
+        for (auto& value : row)
+        {
+            do
+            {
+                const auto bits = random();
+                std::memcpy(&value, &bits, sizeof(value));
+            } while (!std::isfinite(value));
+        }
+    }
+    REQUIRE(csv::write(outPath.string(), rows));
+    const auto read = csv::to_vectors<double>(outPath.string());
+    REQUIRE(read.size() == rows.size());
+    CHECK(std::memcmp(read.front().data(), rows.front().data(), rows.front().size() * sizeof(double)) == 0);
+    CHECK(read == rows);
+
+    std::filesystem::remove(outPath);
+}
+
+TEST_CASE("Floating-point parsing is correctly rounded")
+{
+    const auto parse = [](const std::string& text)
+    {
+        double value;
+        csv::detail::parse_value(text, value);
+        return value;
+    };
+
+    CHECK(parse("3.3l") == 3.3);
+    CHECK(parse(" 0") == 0.0);
+    CHECK(parse("") == 0.0);
+    CHECK(parse("2.2250738585072011e-308") == std::strtod("2.2250738585072011e-308", nullptr));
+    CHECK(parse("4.9406564584124654e-324") == std::strtod("4.9406564584124654e-324", nullptr));
+    CHECK(parse("9007199254740993") == 9007199254740992.0);
+    CHECK(parse("1.00000000000000011102230246251565404236316680908203125") == 1.0);
+    CHECK(parse("1.00000000000000011102230246251565404236316680908203126") == std::nextafter(1.0, 2.0));
+    CHECK(std::isinf(parse("1e400")));
+
+    std::mt19937_64 random(2021);
+    char text[64];
+    for (int i = 0; i < 100000; ++i)
+    {
+        const auto bits = random();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (!std::isfinite(value))
+        {
+            continue;
+        }
+        std::snprintf(text, sizeof(text), "%.*g", static_cast<int>(1 + random() % 20), value);
+        REQUIRE(parse(text) == std::strtod(text, nullptr));
+
+        float single;
+        csv::detail::parse_value(text, single);
+        REQUIRE(single == std::strtof(text, nullptr));
+    }
+}
+
+TEST_CASE("Integer parsing detects overflow")
+{
+    const auto parse = [](const std::string& text, auto value)
+    {
+        const auto parsed = csv::detail::parse_value(text, value);
+        return std::make_pair(value, parsed);
+    };
+
+    CHECK(parse("1234567890123456", 0L) == std::make_pair(1234567890123456L, true));
+    CHECK(parse(" -12345678", 0) == std::make_pair(-12345678, true));
+    CHECK(parse("2.01", 0) == std::make_pair(2, true));
+    CHECK(parse("", 0) == std::make_pair(0, false));
+    CHECK(parse("2147483647", 0) == std::make_pair(2147483647, true));
+    CHECK(parse("2147483648", 0) == std::make_pair(2147483647, false));
+    CHECK(parse("-2147483648", 0) == std::make_pair(-2147483647 - 1, true));
+    CHECK(parse("-9223372036854775808", 0LL) == std::make_pair(std::numeric_limits<long long>::min(), true));
+    CHECK(parse("18446744073709551615", 0ULL) == std::make_pair(std::numeric_limits<unsigned long long>::max(), true));
+    CHECK(parse("18446744073709551616", 0ULL) == std::make_pair(std::numeric_limits<unsigned long long>::max(), false));
+    CHECK(parse("00000000000000000000000042", 0) == std::make_pair(42, true));
+
+    std::mt19937_64 random(2022);
+    for (int i = 0; i < 100000; ++i)
+    {
+        const auto expected = static_cast<long long>(random()) >> (random() % 64);
+        REQUIRE(parse(std::to_string(expected), 0LL) == std::make_pair(expected, true));
+    }
+}
+
+TEST_CASE("Boolean parsing")
+{
+    const auto parse = [](const std::string& text)
+    {
+        bool value = true;
+        const auto parsed = csv::detail::parse_value(text, value);
+        return std::make_pair(value, parsed);
+    };
+
+    for (const auto* text : {"true", "TRUE", " True", "1", "yes", "Y", "\"true\""})
+    {
+        CHECK(parse(std::string(csv::detail::strip_quotes(text))) == std::make_pair(true, true));
+    }
+    for (const auto* text : {"false", "False", "0", "no", "NO"})
+    {
+        CHECK(parse(text) == std::make_pair(false, true));
+    }
+    CHECK(parse("") == std::make_pair(false, false));
+    CHECK(parse("maybe") == std::make_pair(false, false));
+    CHECK(parse("tru") == std::make_pair(true, false));
+    CHECK(parse("\x10") == std::make_pair(false, false));
+    CHECK(parse("\x11") == std::make_pair(false, false));
+
+    CHECK(csv::detail::parse_record<std::tuple<bool, bool, bool>>("yes,,No", ',') == std::make_tuple(true, false, false));
+}
+
+TEST_CASE("Parse statistics")
+{
+    const auto dataPath = dataDir / "test_int_with_header.csv";
+    assert(std::filesystem::exists(dataPath));
+
+    csv::parse_stats stats;
+    std::vector<std::string> header;
+    const auto data = csv::to_vectors<int>(dataPath.string(), header, '\0', &stats);
+    REQUIRE(data.size() == 3);
+
+    CHECK(stats.bytesRead == std::filesystem::file_size(dataPath));
+    CHECK(stats.rows == 3);
+    CHECK(stats.fields == 9);
+    CHECK(stats.conversionFailures == std::vector<size_t>{0, 0, 0});
+    CHECK(stats.allocations > 0);
+    CHECK(stats.ioTime.count() > 0);
+
+    // The header row read as integers fails to convert in every column
+    const auto withHeader = csv::to_tuples<int, csv::ignore, int>(dataPath.string(), '\0', &stats);
+    CHECK(withHeader.size() == 4);
+    CHECK(stats.rows == 4);
+    CHECK(stats.conversionFailures == std::vector<size_t>{1, 0, 1});
+}
+
+TEST_CASE("Row index")
+{
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_index.csv";
+    std::vector<std::tuple<int, std::string, double>> rows;
+    for (int i = 0; i < 50000; ++i)
+    {
+        rows.emplace_back(i, i % 7 == 0 ? "spans\nlines, \"quoted\"" : "plain", i * 0.5);
+    }
+    REQUIRE(csv::write(csvPath.string(), rows, std::array<std::string, 3>{"id", "text", "value"}));
+
+    const auto rowIndex = csv::index::build(csvPath.string(), 100, 4);
+    REQUIRE(!rowIndex.empty());
+    CHECK(rowIndex.rows() == rows.size() + 1);
+
+    const auto check_slice = [&](const csv::index& idx, size_t firstRow, size_t nRows)
+    {
+        const auto slice = csv::to_tuples<int, std::string, double>(csvPath.string(), idx, firstRow, nRows);
+        const auto expectedEnd = std::min(rows.size(), firstRow - 1 + nRows);
+        REQUIRE(slice.size() == expectedEnd - (firstRow - 1));
+        CHECK(std::equal(slice.cbegin(), slice.cend(), rows.cbegin() + static_cast<long>(firstRow - 1)));
+    };
+    check_slice(rowIndex, 1, 10);
+    check_slice(rowIndex, 4999, 3);
+    check_slice(rowIndex, 30000, 1000);
+    check_slice(rowIndex, 49990, 100);
+
+    // Rows are records as the index counts them, in the first stride as after it, whatever skipRows says
+    csv::read_options skipping;
+    skipping.skipRows = 2;
+    for (const size_t firstRow : {5, 100, 150})
+    {
+        const auto slice = csv::to_tuples<int, std::string, double>(csvPath.string(), rowIndex, firstRow, 1, skipping);
+        REQUIRE(slice.size() == 1);
+        CHECK(slice.front() == rows[firstRow - 1]);
+    }
+
+    SECTION("persisted next to the file")
+    {
+        REQUIRE(rowIndex.save(csvPath.string()));
+        const auto loaded = csv::index::load(csvPath.string());
+        REQUIRE(!loaded.empty());
+        CHECK(loaded.rows() == rowIndex.rows());
+        check_slice(loaded, 12345, 50);
+
+        // A changed file invalidates the index
+        std::ofstream(csvPath, std::ios::app) << "1,x,2\n";
+        CHECK(csv::index::load(csvPath.string()).empty());
+        std::filesystem::remove(csv::index::sidecar_path(csvPath.string()));
+    }
+
+    std::filesystem::remove(csvPath);
+}
+
+TEST_CASE("Skip, limit and comments")
+{
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_options.csv";
+    {
+        std::ofstream file(csvPath, std::ios::binary);
+        file << "exported by some tool\n\"unbalanced \" quote\n" // preamble
+             << "a;b\n# note\n1;2\n3;4\n#\n5;6\n7;8";
+    }
+    csv::read_options options;
+    options.skipRows = 2;
+    options.commentPrefix = "#";
+
+    std::vector<std::string> header;
+    auto data = csv::to_vectors<int>(csvPath.string(), header, options);
+    CHECK(header == std::vector<std::string>{"a", "b"});
+    CHECK(data == std::vector<std::vector<int>>{{1, 2}, {3, 4}, {5, 6}, {7, 8}});
+    CHECK(csv::get_header(csvPath.string(), options) == header);
+
+    options.maxRows = 3;
+    data = csv::to_vectors<int>(csvPath.string(), header, options);
+    CHECK(data == std::vector<std::vector<int>>{{1, 2}, {3, 4}, {5, 6}});
+
+    options.skipRows = 5;
+    options.maxRows = 1;
+    CHECK(csv::to_arrays<int, 2>(csvPath.string(), options) == std::vector<std::array<int, 2>>{{3, 4}});
+
+    options.skipRows = 100;
+    CHECK(csv::to_tuples<int, int>(csvPath.string(), options).empty());
+
+    std::filesystem::remove(csvPath);
+}
+
+TEST_CASE("Row filters")
+{
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_filter.csv";
+    const std::array<std::string, 4> symbols{"AAPL", "MSFT", "AAPL, Inc.", "note AAPL"};
+    std::vector<std::tuple<int, std::string, std::string>> rows;
+    for (int i = 0; i < 100000; ++i)
+    {
+        rows.emplace_back(i, symbols[i % 7 % 4], symbols[i % 5 % 4]);
+    }
+    REQUIRE(csv::write(csvPath.string(), rows));
+    std::ofstream(csvPath, std::ios::app) << "1\n"; // too few fields for the filter
+
+    const auto expect = [&](auto keep)
+    {
+        std::vector<std::tuple<int, std::string, std::string>> kept;
+        std::copy_if(rows.cbegin(), rows.cend(), std::back_inserter(kept), keep);
+        return kept;
+    };
+    for (const auto& symbol : symbols)
+    {
+        csv::read_options options;
+        options.where_equal(1, symbol);
+        CHECK(csv::to_tuples<int, std::string, std::string>(csvPath.string(), options)
+              == expect([&](const auto& row) { return std::get<1>(row) == symbol; }));
+    }
+
+    csv::read_options options;
+    options.where<int>(0, [](int id) { return id % 1000 == 7; });
+    options.maxRows = 20;
+    const auto data = csv::to_tuples<int, std::string, std::string>(csvPath.string(), options);
+    auto expected = expect([](const auto& row) { return std::get<0>(row) % 1000 == 7; });
+    expected.resize(20);
+    CHECK(data == expected);
+
+    std::filesystem::remove(csvPath);
+}
+
+TEST_CASE("Following a growing file")
+{
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_follow.csv";
+    std::ofstream(csvPath, std::ios::binary) << "id;name\n1;a\n2;b";
+
+    csv::follower<std::tuple<int, std::string>> follower(csvPath.string(), {}, true);
+    using Rows = std::vector<std::tuple<int, std::string>>;
+    CHECK(follower.poll() == Rows{{1, "a"}});
+    CHECK(follower.header() == std::vector<std::string>{"id", "name"});
+    CHECK(follower.poll().empty());
+
+    std::ofstream(csvPath, std::ios::binary | std::ios::app) << "b\n3;\"multi\nline\"";
+    CHECK(follower.poll() == Rows{{2, "bb"}});
+    std::ofstream(csvPath, std::ios::binary | std::ios::app) << "\r\n";
+    CHECK(follower.poll() == Rows{{3, "multi\nline"}});
+    CHECK(follower.offset() == std::filesystem::file_size(csvPath));
+
+    // An append from elsewhere wakes a waiting follower
+    std::thread writer([&]
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        std::ofstream(csvPath, std::ios::binary | std::ios::app) << "4;d\n";
+    });
+    Rows rows;
+    for (int i = 0; i < 100 && rows.empty(); ++i)
+    {
+        rows = follower.wait(std::chrono::milliseconds(100));
+    }
+    writer.join();
+    CHECK(rows == Rows{{4, "d"}});
+    CHECK(follower.wait(std::chrono::milliseconds(10)).empty());
+
+    // A truncated file is read again from the start
+    std::ofstream(csvPath, std::ios::binary) << "id;name\n5;e\n";
+    CHECK(follower.poll() == Rows{{5, "e"}});
+
+    std::filesystem::remove(csvPath);
+}
+
+TEST_CASE("Resuming from a checkpoint")
+{
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_resume.csv";
+    std::vector<std::tuple<int, std::string>> rows;
+    for (int i = 0; i < 1000; ++i)
+    {
+        rows.emplace_back(i, i % 3 ? "plain" : "with \"quotes\"\nand a line break");
+    }
+    REQUIRE(csv::write(csvPath.string(), rows, std::array<std::string, 2>{"id", "a; b"}, {';'}));
+
+    std::vector<std::tuple<int, std::string>> data;
+    std::tuple<int, std::string> row;
+    csv::checkpoint point;
+    {
+        csv::reader<std::tuple<int, std::string>> reader(csvPath.string(), {}, true);
+        REQUIRE(reader);
+        for (int i = 0; i < 300 && reader.next(row); ++i)
+        {
+            data.push_back(row);
+        }
+        point = reader.position();
+        CHECK(point.row == 300);
+        CHECK(point.header == std::vector<std::string>{"id", "a; b"});
+    }
+
+    csv::checkpoint restored;
+    REQUIRE(csv::checkpoint::deserialize(point.serialize(), restored));
+    CHECK(restored.offset == point.offset);
+    CHECK(restored.delimiter == ';');
+    CHECK(restored.header == point.header);
+    CHECK(!csv::checkpoint::deserialize("stdcsv-checkpoint 1 12 3", restored));
+    CHECK(!csv::checkpoint::deserialize(point.serialize() + "x", restored));
+
+    const auto checkpointPath = csvPath.string() + ".checkpoint";
+    REQUIRE(point.save(checkpointPath));
+    REQUIRE(point.save(checkpointPath)); // replaces the first one
+    REQUIRE(csv::checkpoint::load(checkpointPath, restored));
+    CHECK_FALSE(std::filesystem::exists(checkpointPath + ".tmp"));
+    CHECK_FALSE(point.save((std::filesystem::temp_directory_path() / "std_csv_missing" / "checkpoint").string()));
+    std::filesystem::remove(checkpointPath);
+
+    csv::reader<std::tuple<int, std::string>> reader(csvPath.string(), restored);
+    while (reader.next(row))
+    {
+        data.push_back(row);
+    }
+    CHECK(reader.rows() == rows.size());
+    CHECK(reader.header() == point.header);
+    CHECK(data == rows);
+
+    std::filesystem::remove(csvPath);
+}
+
+TEST_CASE("Dialects")
+{
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_dialect.csv";
+    std::ofstream(csvPath, std::ios::binary) << "1|'a|b'|2.5\r\n2|'it''s'|3\r\n";
+    using Rows = std::vector<std::tuple<int, std::string, double>>;
+    const Rows expected{{1, "a|b", 2.5}, {2, "it's", 3}};
+
+    CHECK(csv::to_tuples<int, std::string, double>(csvPath.string(), csv::dialect<'|', '\''>{}) == expected);
+    std::array<std::string, 3> header;
+    CHECK(csv::to_tuples<int, std::string, double>(csvPath.string(), header, csv::dialect<'|', '\''>{})
+          == Rows{expected.back()});
+    CHECK(header == std::array<std::string, 3>{"1", "a|b", "2.5"});
+    CHECK(csv::to_vectors<std::string>(csvPath.string(), csv::dialect<'|', '\''>{}).back()
+          == std::vector<std::string>{"2", "it's", "3"});
+    csv::read_options firstRow;
+    firstRow.maxRows = 1;
+    CHECK(csv::to_arrays<double, 3>(csvPath.string(), csv::dialect<'|', '\''>{}, firstRow).size() == 1);
+
+    csv::reader<std::tuple<int, std::string, double>, csv::dialect<'|', '\''>> reader(csvPath.string());
+    Rows data;
+    for (std::tuple<int, std::string, double> row; reader.next(row);)
+    {
+        data.push_back(row);
+    }
+    CHECK(data == expected);
+
+    // Records ending with ';' instead of a line break
+    std::ofstream(csvPath, std::ios::binary) << "1,\"x;y\";2,z;";
+    csv::read_options options;
+    options.lineBreak = ';';
+    CHECK(csv::to_vectors<std::string>(csvPath.string(), options)
+          == std::vector<std::vector<std::string>>{{"1", "x;y"}, {"2", "z"}});
+
+    std::filesystem::remove(csvPath);
+}
+
+TEST_CASE("Ignored columns")
+{
+    const auto record = R"(1,"a,b",x,2.5,"""q"", r",,7,tail,"t,u")";
+    using Row = std::tuple<int, csv::ignore, csv::ignore, double, std::string, csv::ignore, int, csv::ignore,
+                           csv::ignore>;
+    CHECK(csv::detail::parse_record<Row>(record, ',') == std::make_tuple(1, 2.5, std::string("\"q\", r"), 7));
+    CHECK(csv::detail::parse_record<std::tuple<csv::ignore, csv::ignore, std::string>>(record, ',')
+          == std::make_tuple(std::string("x")));
+    CHECK(csv::detail::parse_record<std::tuple<csv::ignore, csv::ignore>>(record, ',') == std::tuple<>{});
+
+    // A short record leaves the columns past its end default-valued
+    CHECK(csv::detail::parse_record<std::tuple<int, csv::ignore, csv::ignore, int>>("4,5", ',')
+          == std::make_tuple(4, 0));
+}
+
+TEST_CASE("Schema inference and tables")
+{
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_schema.csv";
+    {
+        std::ofstream file(csvPath, std::ios::binary);
+        file << "id,price,active,when,label,score\n";
+        for (int i = 0; i < 200000; ++i)
+        {
+            file << i << ',' << i * 0.25 << ',' << (i % 2 ? "true" : "false") << ",2024-01-"
+                 << (i % 28 + 1 < 10 ? "0" : "") << i % 28 + 1 << "T12:00:00Z," << (i % 3 ? "\"x, y\"" : "z") << ','
+                 << (i % 10 ? std::to_string(i % 7) : "") << '\n';
+        }
+    }
+
+    const auto inferred = csv::infer_schema(csvPath.string(), {}, 2000, 4);
+    CHECK(inferred.header);
+    CHECK(inferred.delimiter == ',');
+    REQUIRE(inferred.columns.size() == 6);
+    const std::vector<std::pair<std::string, csv::column_type>> expected{
+            {"id", csv::column_type::integer}, {"price", csv::column_type::floating},
+            {"active", csv::column_type::boolean}, {"when", csv::column_type::date},
+            {"label", csv::column_type::string}, {"score", csv::column_type::integer}};
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        CHECK(inferred.columns[i].name == expected[i].first);
+        CHECK(inferred.columns[i].type == expected[i].second);
+        CHECK(inferred.columns[i].nullable == (i == 5));
+    }
+
+    const auto data = csv::read_table(csvPath.string());
+    REQUIRE(data.rows() == 200000);
+    REQUIRE(data.columns() == 6);
+    CHECK(data.values<int64_t>(0)[12345] == 12345);
+    CHECK(data.values<double>(1)[3] == 0.75);
+    CHECK(data.values<bool>(2)[1]);
+    CHECK(data.values<std::string>(4)[1] == "x, y");
+    CHECK(std::chrono::duration_cast<std::chrono::seconds>(data.values<std::chrono::system_clock::time_point>(3)[0]
+                                                           .time_since_epoch()).count() == 1704110400);
+    REQUIRE(data.find("score") != nullptr);
+    CHECK(data.find("score")->nulls[10]);
+    CHECK(!data.find("score")->nulls[11]);
+    CHECK(data.find("missing") == nullptr);
+
+    // A value the sample did not see is stored as a null
+    std::ofstream(csvPath, std::ios::binary | std::ios::app) << "oops,1,true,2024-02-01,a,1\n";
+    const auto appended = csv::read_table(csvPath.string(), inferred);
+    CHECK(appended[0].schema.nullable);
+    CHECK(appended[0].nulls.back());
+    CHECK(!appended[0].nulls.front());
+
+    std::filesystem::remove(csvPath);
+}
+
+TEST_CASE("Schema inference without a header")
+{
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_no_header.csv";
+    std::ofstream(csvPath, std::ios::binary) << "1;2.5;yes\n2;NA;no\n3;4;n\n";
+    const auto inferred = csv::infer_schema(csvPath.string());
+    CHECK(!inferred.header);
+    CHECK(inferred.delimiter == ';');
+    REQUIRE(inferred.columns.size() == 3);
+    CHECK(inferred.columns[0].type == csv::column_type::integer);
+    CHECK(inferred.columns[1].type == csv::column_type::floating);
+    CHECK(inferred.columns[1].nullable);
+    CHECK(inferred.columns[2].type == csv::column_type::boolean);
+    CHECK(csv::read_table(csvPath.string()).rows() == 3);
+
+    // A null in the first row is not taken for a header name
+    std::ofstream(csvPath, std::ios::binary) << "1,,x\n2,3,y\n3,4,z\n";
+    const auto withNull = csv::infer_schema(csvPath.string());
+    CHECK(!withNull.header);
+    REQUIRE(withNull.columns.size() == 3);
+    CHECK(withNull.columns[1].type == csv::column_type::integer);
+    CHECK(withNull.columns[1].nullable);
+    CHECK(csv::detail::classify("") == csv::column_type::string);
+    std::filesystem::remove(csvPath);
+}
+
+TEST_CASE("Column aggregation")
+{
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_aggregate.csv";
+    std::vector<std::tuple<int, std::string, double>> rows;
+    for (int i = 0; i < 200000; ++i)
+    {
+        rows.emplace_back(i % 1000, i % 11 ? "text\nover lines, \"quoted\"" : "", std::sin(i) * 100);
+    }
+    REQUIRE(csv::write(csvPath.string(), rows, std::array<std::string, 3>{"n", "text", "x"}));
+    std::ofstream(csvPath, std::ios::binary | std::ios::app) << "NA,,oops\n";
+
+    csv::column_summary expectedN, expectedX;
+    for (const auto& [n, text, x] : rows)
+    {
+        expectedN.add(n);
+        expectedX.add(x);
+    }
+    const auto check = [](const csv::column_summary& summary, const csv::column_summary& expected)
+    {
+        CHECK(summary.count == expected.count);
+        CHECK(summary.min == expected.min);
+        CHECK(summary.max == expected.max);
+        CHECK(std::abs(summary.sum - expected.sum) <= 1e-9 * std::abs(expected.sum) + 1e-6);
+        CHECK(std::abs(summary.mean - expected.mean) <= 1e-9 * std::abs(expected.mean) + 1e-9);
+        CHECK(std::abs(summary.variance() - expected.variance()) <= 1e-9 * expected.variance());
+    };
+
+    std::vector<std::string> header;
+    const auto summaries = csv::aggregate(csvPath.string(), header, {2, 0}, {}, 8);
+    CHECK(header == std::vector<std::string>{"n", "text", "x"});
+    REQUIRE(summaries.size() == 2);
+    check(summaries[0], expectedX);
+    check(summaries[1], expectedN);
+    CHECK(summaries[0].invalid == 1);
+    CHECK(summaries[1].nulls == 1);
+
+    // A column asked for more than once is summarized each time
+    const auto repeated = csv::aggregate(csvPath.string(), header, {2, 0, 2, 0}, {}, 8);
+    REQUIRE(repeated.size() == 4);
+    check(repeated[0], expectedX);
+    check(repeated[1], expectedN);
+    check(repeated[2], expectedX);
+    check(repeated[3], expectedN);
+
+    const auto all = csv::aggregate(csvPath.string());
+    REQUIRE(all.size() == 3);
+    CHECK(all[0].count == rows.size());
+    CHECK(all[0].invalid == 1); // the header
+    CHECK(all[1].nulls == rows.size() / 11 + 2);
+    CHECK(all[1].invalid == rows.size() - rows.size() / 11); // and the header
+
+    std::filesystem::remove(csvPath);
+}
+
+TEST_CASE("Group by")
+{
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_group_by.csv";
+    const std::array<std::string, 5> symbols{"AAPL", "MSFT", "with, comma", "with \"quote\"",
+                                             "a long key over eight bytes"};
+    std::vector<std::tuple<std::string, int, double>> rows;
+    for (int i = 0; i < 200000; ++i)
+    {
+        rows.emplace_back(symbols[i % 5] + std::to_string(i % 13), i % 100, i * 0.5);
+    }
+    REQUIRE(csv::write(csvPath.string(), rows, std::array<std::string, 3>{"symbol", "size", "price"}));
+
+    std::map<std::string, std::pair<csv::column_summary, csv::column_summary>> expected;
+    for (const auto& [symbol, size, price] : rows)
+    {
+        expected[symbol].first.add(price);
+        expected[symbol].second.add(size);
+    }
+
+    std::vector<std::string> header;
+    const auto result = csv::group_by(csvPath.string(), header, 0, {2, 1}, {}, 4);
+    CHECK(header == std::vector<std::string>{"symbol", "size", "price"});
+    REQUIRE(result.size() == expected.size());
+    size_t group = 0;
+    for (const auto& [key, summaries] : expected)
+    {
+        CHECK(result.keys[group] == key);
+        CHECK(result.summary(group, 0).count == summaries.first.count);
+        CHECK(result.summary(group, 0).sum == summaries.first.sum);
+        CHECK(result.summary(group, 0).max == summaries.first.max);
+        CHECK(result.summary(group, 1).min == summaries.second.min);
+        CHECK(std::abs(result.summary(group, 1).mean - summaries.second.mean) < 1e-9);
+        ++group;
+    }
+
+    // The key column, or a value column, may be asked for again as a value
+    const auto repeated = csv::group_by(csvPath.string(), header, 1, {1, 2, 1}, {}, 4);
+    REQUIRE(repeated.size() == 100);
+    const auto size42 = static_cast<size_t>(std::find(repeated.keys.cbegin(), repeated.keys.cend(), "42")
+                                            - repeated.keys.cbegin());
+    REQUIRE(size42 < repeated.size());
+    CHECK(repeated.summary(size42, 0).min == 42);
+    CHECK(repeated.summary(size42, 0).max == 42);
+    CHECK(repeated.summary(size42, 1).count == 2000);
+    CHECK(repeated.summary(size42, 1).min == 21);
+    CHECK(repeated.summary(size42, 2).sum == repeated.summary(size42, 0).sum);
+
+    const auto limited = csv::group_by(csvPath.string(), 1, {});
+    CHECK(limited.size() == 101); // 100 sizes and the header's
+    CHECK(limited.nValues == 0);
+
+    std::filesystem::remove(csvPath);
+}
+
+TEST_CASE("Distinct counts and quantiles")
+{
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_sketch.csv";
+    std::vector<std::tuple<std::string, int, double>> rows;
+    for (int i = 0; i < 300000; ++i)
+    {
+        // Values in a scrambled order so that compactions see them unsorted
+        const auto value = (i * int64_t(7919)) % 300000;
+        rows.emplace_back("user" + std::to_string(i % 50000), i % 10, value * 0.5);
+    }
+    REQUIRE(csv::write(csvPath.string(), rows, std::array<std::string, 3>{"user", "digit", "value"}));
+
+    std::vector<std::string> header;
+    const auto sketches = csv::sketch(csvPath.string(), header, {0, 2, 1}, {}, 4);
+    CHECK(header == std::vector<std::string>{"user", "digit", "value"});
+    REQUIRE(sketches.size() == 3);
+    CHECK(std::abs(sketches[0].distinct.estimate() - 50000) < 50000 * 0.05);
+    CHECK(sketches[0].quantiles.count() == 0);
+    CHECK(std::abs(sketches[1].distinct.estimate() - 300000) < 300000 * 0.05);
+    CHECK(std::abs(sketches[2].distinct.estimate() - 10) < 0.5);
+    CHECK(sketches[1].quantiles.count() == 300000);
+    CHECK(sketches[1].quantiles.min() == 0);
+    CHECK(sketches[1].quantiles.max() == 149999.5);
+    for (const auto q : {0.01, 0.25, 0.5, 0.9, 0.99})
+    {
+        CHECK(std::abs(sketches[1].quantiles.quantile(q) - q * 150000) < 150000 * 0.02);
+    }
+    CHECK(sketches[2].quantiles.quantile(0.5) == Approx(4).margin(1));
+
+    // Sketches of parts merge into the sketch of the whole
+    csv::kll_sketch low, high;
+    csv::hyperloglog lowDistinct, highDistinct;
+    for (int i = 0; i < 100000; ++i)
+    {
+        (i < 50000 ? low : high).add(i);
+        (i < 70000 ? lowDistinct : highDistinct).add(std::to_string(i % 60000));
+    }
+    low.merge(high);
+    lowDistinct.merge(highDistinct);
+    CHECK(low.count() == 100000);
+    CHECK(std::abs(low.quantile(0.5) - 50000) < 2000);
+    CHECK(std::abs(lowDistinct.estimate() - 60000) < 60000 * 0.05);
+    CHECK(std::isnan(csv::kll_sketch().quantile(0.5)));
+
+    std::filesystem::remove(csvPath);
+}
+
+TEST_CASE("External sort")
+{
+    const auto inputPath = std::filesystem::temp_directory_path() / "std_csv_sort_in.csv";
+    const auto outputPath = std::filesystem::temp_directory_path() / "std_csv_sort_out.csv";
+    std::vector<std::tuple<int64_t, double, std::string, int>> rows;
+    for (int64_t i = 0; i < 100000; ++i)
+    {
+        const auto scrambled = (i * 7919) % 100000;
+        const auto name = "name \"" + std::to_string(scrambled % 97) + '"';
+        rows.emplace_back(scrambled - 50000, (scrambled % 1000) * -0.5, name, static_cast<int>(i));
+    }
+    REQUIRE(csv::write(inputPath.string(), rows, std::array<std::string, 4>{"id", "value", "name", "order"}));
+
+    // Runs of about 64 KB each, merged
+    csv::sort_options sortOptions;
+    sortOptions.memoryBudget = 1 << 16;
+    sortOptions.threads = 4;
+    REQUIRE(csv::sort_file(inputPath.string(), outputPath.string(), 0, csv::column_type::integer, {}, sortOptions));
+    std::array<std::string, 4> header;
+    auto sorted = csv::to_tuples<int64_t, double, std::string, int>(outputPath.string(), header);
+    CHECK(header == std::array<std::string, 4>{"id", "value", "name", "order"});
+    auto expected = rows;
+    std::sort(expected.begin(), expected.end());
+    CHECK(sorted == expected);
+
+    // Stable, with ties kept in input order
+    REQUIRE(csv::sort_file(inputPath.string(), outputPath.string(), 1, csv::column_type::floating, {}, sortOptions));
+    sorted = csv::to_tuples<int64_t, double, std::string, int>(outputPath.string(), header);
+    expected = rows;
+    std::stable_sort(expected.begin(), expected.end(), [](const auto& a, const auto& b)
+    {
+        return std::get<1>(a) < std::get<1>(b);
+    });
+    CHECK(sorted == expected);
+
+    // Text keys are unquoted, and descending order reverses ties too
+    sortOptions.descending = true;
+    REQUIRE(csv::sort_file(inputPath.string(), outputPath.string(), 2, csv::column_type::string, {}, sortOptions));
+    sorted = csv::to_tuples<int64_t, double, std::string, int>(outputPath.string(), header);
+    REQUIRE(sorted.size() == rows.size());
+    CHECK(std::get<2>(sorted.front()) == "name \"96\"");
+    CHECK(std::get<2>(sorted.back()) == "name \"0\"");
+    CHECK(std::is_sorted(sorted.rbegin(), sorted.rend(), [](const auto& a, const auto& b)
+    {
+        return std::get<2>(a) < std::get<2>(b) || (std::get<2>(a) == std::get<2>(b) && std::get<3>(a) > std::get<3>(b));
+    }));
+
+    // Records keep the line breaks of the input
+    std::ofstream(inputPath, std::ios::binary) << "id,name\r\n3,\"c\r\nd\"\r\n1,a\r\n\r\n2,b";
+    REQUIRE(csv::sort_file(inputPath.string(), outputPath.string(), 0, csv::column_type::integer));
+    std::ifstream sortedFile(outputPath, std::ios::binary);
+    CHECK(std::string(std::istreambuf_iterator<char>(sortedFile), {}) == "id,name\r\n1,a\r\n2,b\r\n3,\"c\r\nd\"\r\n");
+    sortedFile.close();
+
+    CHECK_FALSE(csv::sort_file("missing.csv", outputPath.string(), 0, csv::column_type::integer));
+    std::filesystem::remove(inputPath);
+    std::filesystem::remove(outputPath);
+}
+
+TEST_CASE("Hash join")
+{
+    const auto factsPath = std::filesystem::temp_directory_path() / "std_csv_join_facts.csv";
+    const auto namesPath = std::filesystem::temp_directory_path() / "std_csv_join_names.csv";
+    const auto outputPath = std::filesystem::temp_directory_path() / "std_csv_join_out.csv";
+    std::vector<std::tuple<std::string, int>> facts;
+    for (int i = 0; i < 200000; ++i)
+    {
+        facts.emplace_back("key \"" + std::to_string(i % 1100) + '"', i);
+    }
+    REQUIRE(csv::write(factsPath.string(), facts, std::array<std::string, 2>{"key", "amount"}));
+    // Keys 0 to 999, and 7 twice, delimited differently from the facts
+    {
+        std::ofstream names(namesPath);
+        names << "name;key\n";
+        for (int i = 0; i < 1000; ++i)
+        {
+            names << "name " << i << ";\"key \"\"" << i << "\"\"\"\n";
+        }
+        names << "seven again;\"key \"\"7\"\"\"\n";
+    }
+
+    csv::join_options joinOptions;
+    joinOptions.threads = 4;
+    size_t nMatches = 0, nUnmatched = 0;
+    int lastAmount = -1;
+    bool ordered = true;
+    REQUIRE(csv::join(factsPath.string(), 0, namesPath.string(), 1,
+                      [&](std::string_view fact, std::string_view name)
+                      {
+                          const auto amount = std::stoi(std::string(fact.substr(fact.rfind(',') + 1)));
+                          ordered = ordered && amount >= lastAmount;
+                          lastAmount = amount;
+                          ++(name.empty() ? nUnmatched : nMatches);
+                      },
+                      {}, joinOptions));
+    CHECK(ordered);
+    CHECK(nMatches == 181 * 1000 + 900 + 182); // 181 full rounds of the 1100 keys, then keys 0 to 899
+    CHECK(nUnmatched == 0);
+
+    joinOptions.keepUnmatched = true;
+    REQUIRE(csv::join_file(factsPath.string(), 0, namesPath.string(), 1, outputPath.string(), {}, joinOptions));
+    std::array<std::string, 4> header;
+    const auto joined = csv::to_tuples<std::string, int, std::string, std::string>(outputPath.string(), header);
+    CHECK(header == std::array<std::string, 4>{"key", "amount", "name", "key"});
+    REQUIRE(joined.size() == 200000 + 182);
+    CHECK(joined[7] == std::make_tuple(std::string("key \"7\""), 7, std::string("name 7"), std::string("key \"7\"")));
+    CHECK(std::get<2>(joined[8]) == "seven again");
+    CHECK(joined[1001] == std::make_tuple(std::string("key \"1000\""), 1000, std::string(), std::string()));
+
+    CHECK_FALSE(csv::join_file("missing.csv", 0, namesPath.string(), 1, outputPath.string()));
+    std::filesystem::remove(factsPath);
+    std::filesystem::remove(namesPath);
+    std::filesystem::remove(outputPath);
+}
+
+TEST_CASE("Row counts")
+{
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_count.csv";
+    std::vector<std::tuple<int, std::string, double>> rows;
+    for (int i = 0; i < 50000; ++i)
+    {
+        rows.emplace_back(i, i % 7 == 0 ? "spans\nlines, \"quoted\"" : "plain", i * 0.5);
+    }
+    REQUIRE(csv::write(csvPath.string(), rows, std::array<std::string, 3>{"id", "text", "value"}));
+    CHECK(csv::count_rows(csvPath.string(), 4) == rows.size() + 1);
+    CHECK(csv::count_rows(csvPath.string(), 1, false) == rows.size() + 1 + (rows.size() + 6) / 7);
+    CHECK(csv::count_rows("missing.csv") == 0);
+
+    // The count seeds the loaders' reservation, so the rows are stored without growing
+    std::vector<std::tuple<int, double>> numbers(100000, {1, 0.5});
+    REQUIRE(csv::write(csvPath.string(), numbers));
+    std::ofstream(csvPath, std::ios::app) << "2,0.25"; // a last row without a line break
+    csv::read_options options;
+    options.expectedRows = csv::count_rows(csvPath.string());
+    CHECK(options.expectedRows == numbers.size() + 1);
+    csv::parse_stats stats;
+    const auto loaded = csv::to_tuples<int, double>(csvPath.string(), options, &stats);
+    CHECK(loaded.size() == numbers.size() + 1);
+    CHECK(loaded.capacity() == loaded.size());
+    CHECK(stats.allocations == 1);
+
+    std::filesystem::remove(csvPath);
+}
+
+TEST_CASE("Progress and cancellation")
+{
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_progress.csv";
+    std::vector<std::tuple<int, double>> rows(500000, {12345, 0.125});
+    REQUIRE(csv::write(csvPath.string(), rows));
+    const auto fileSize = std::filesystem::file_size(csvPath);
+
+    csv::read_options options;
+    std::vector<csv::load_progress> reports;
+    options.onProgress = [&reports](const csv::load_progress& progress) { reports.push_back(progress); };
+    CHECK(csv::to_tuples<int, double>(csvPath.string(), options).size() == rows.size());
+    REQUIRE(reports.size() > 2); // a report per block of 1 MB, and one at the end
+    for (size_t i = 1; i < reports.size(); ++i)
+    {
+        CHECK(reports[i].bytes >= reports[i - 1].bytes);
+        CHECK(reports[i].rows >= reports[i - 1].rows);
+    }
+    CHECK(reports.back().bytes == fileSize);
+    CHECK(reports.back().totalBytes == fileSize);
+    CHECK(reports.back().rows == rows.size());
+    CHECK(reports.back().throughput() > 0);
+
+    // Cancelling keeps the rows read until the next block
+    std::atomic<bool> cancel{false};
+    options.cancel = &cancel;
+    options.onProgress = [&cancel](const csv::load_progress& progress) { cancel = progress.rows > 0; };
+    const auto partial = csv::to_tuples<int, double>(csvPath.string(), options);
+    CHECK(partial.size() > 0);
+    CHECK(partial.size() < rows.size());
+
+    std::filesystem::remove(csvPath);
+}
+
+TEST_CASE("Reader iteration")
+{
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_iteration.csv";
+    std::vector<std::tuple<int, double>> rows;
+    for (int i = 0; i < 5000; ++i)
+    {
+        rows.emplace_back(i, i * 1.5);
+    }
+    REQUIRE(csv::write(csvPath.string(), rows, std::array<std::string, 2>{"id", "value"}));
+
+    csv::reader<std::tuple<int, double>> reader(csvPath.string(), {}, true);
+    std::vector<std::tuple<int, double>> read;
+    for (const auto& row : reader)
+    {
+        read.push_back(row);
+    }
+    CHECK(read == rows);
+    CHECK(reader.begin() == reader.end());
+
+    std::filesystem::remove(csvPath);
+}
+
+TEST_CASE("Pipelined reading")
+{
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_pipeline.csv";
+    std::vector<std::tuple<int, std::string, double>> rows;
+    for (int i = 0; i < 100000; ++i)
+    {
+        rows.emplace_back(i, i % 9 == 0 ? "spans\nlines, \"quoted\"" : "plain", i * 0.5);
+    }
+    REQUIRE(csv::write(csvPath.string(), rows, std::array<std::string, 3>{"id", "text", "value"}));
+    std::ofstream(csvPath, std::ios::app) << "100000,last,0.25"; // without a line break
+
+    // Small blocks and queues, so that every stage waits on the others
+    csv::pipeline_options pipelineOptions;
+    pipelineOptions.parseThreads = 3;
+    pipelineOptions.queueDepth = 2;
+    pipelineOptions.blockSize = 1 << 12;
+    std::vector<std::string> header;
+    std::vector<std::tuple<int, std::string, double>> read;
+    REQUIRE(csv::for_each_row<std::tuple<int, std::string, double>>(
+            csvPath.string(), &header, [&read](auto& row) { read.push_back(std::move(row)); }, {}, pipelineOptions));
+    CHECK(header == std::vector<std::string>{"id", "text", "value"});
+    REQUIRE(read.size() == rows.size() + 1);
+    CHECK(std::equal(rows.cbegin(), rows.cend(), read.cbegin()));
+    CHECK(read.back() == std::make_tuple(100000, std::string("last"), 0.25));
+
+    // Stopping early, by the consumer or by a row limit
+    size_t nRows = 0;
+    CHECK(csv::for_each_row<std::tuple<int, csv::ignore, csv::ignore>>(
+            csvPath.string(), &header, [&nRows](const auto&) { return ++nRows < 1000; }, {}, pipelineOptions));
+    CHECK(nRows == 1000);
+    csv::read_options options;
+    options.maxRows = 10;
+    nRows = 0;
+    CHECK(csv::for_each_row<std::tuple<int, csv::ignore, csv::ignore>>(
+            csvPath.string(), &header, [&nRows](const auto&) { ++nRows; }, options, pipelineOptions));
+    CHECK(nRows == 10);
+
+    // An exception from the consumer stops the other stages before it leaves
+    nRows = 0;
+    const auto failing = [&nRows](const auto&)
+    {
+        if (++nRows == 5000)
+        {
+            throw std::runtime_error("consumer failed");
+        }
+    };
+    using Ids = std::tuple<int, csv::ignore, csv::ignore>;
+    CHECK_THROWS_AS(csv::for_each_row<Ids>(csvPath.string(), failing, {}, pipelineOptions), std::runtime_error);
+    CHECK(nRows == 5000);
+
+    // So does one from a parse thread, here thrown by a filter, and it is rethrown on the calling thread
+    csv::read_options throwing;
+    throwing.where(0, [](std::string_view text)
+    {
+        if (text == "5000")
+        {
+            throw std::runtime_error("bad row");
+        }
+        return true;
+    });
+    nRows = 0;
+    const auto counting = [&nRows](const auto&) { ++nRows; };
+    CHECK_THROWS_WITH(csv::for_each_row<Ids>(csvPath.string(), &header, counting, throwing, pipelineOptions),
+                      "bad row");
+    CHECK(nRows <= 5000);
+
+    CHECK_FALSE(csv::for_each_row<std::tuple<int>>("missing.csv", [](const auto&) { }));
+    std::filesystem::remove(csvPath);
+}
+
+TEST_CASE("NUMA partitions")
+{
+    CHECK(csv::detail::parse_cpu_list("0-3,8,10-11\n") == std::vector<int>{0, 1, 2, 3, 8, 10, 11});
+    CHECK(csv::detail::parse_cpu_list("").empty());
+    const auto nodes = csv::detail::numa_nodes();
+    REQUIRE_FALSE(nodes.empty());
+
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_partitions.csv";
+    std::vector<std::tuple<int, std::string>> rows;
+    for (int i = 0; i < 200000; ++i)
+    {
+        rows.emplace_back(i, i % 7 == 0 ? "two\nlines" : "one");
+    }
+    REQUIRE(csv::write(csvPath.string(), rows, std::array<std::string, 2>{"id", "text"}));
+
+    for (const auto pin : {true, false})
+    {
+        csv::parallel_options parallelOptions;
+        parallelOptions.threads = 4;
+        parallelOptions.pinThreads = pin;
+        std::vector<std::string> header;
+        const auto partitions = csv::to_partitions<int, std::string>(csvPath.string(), &header, {}, parallelOptions);
+        CHECK(header == std::vector<std::string>{"id", "text"});
+        REQUIRE(!partitions.empty());
+        CHECK(partitions.size() <= nodes.size());
+        std::vector<std::tuple<int, std::string>> gathered;
+        for (const auto& part : partitions)
+        {
+            gathered.insert(gathered.end(), part.rows.begin(), part.rows.end());
+        }
+        CHECK(gathered == rows);
+        const auto merged = csv::to_tuples<int, std::string>(csvPath.string(), nullptr, {}, parallelOptions);
+        CHECK(merged.size() == rows.size() + 1);
+    }
+
+    // Row limits and filters are applied as by the other readers
+    csv::read_options options;
+    options.maxRows = 10;
+    options.where(1, [](std::string_view text) { return text == "one"; });
+    std::vector<std::string> header;
+    const auto limited = csv::to_tuples<int, csv::ignore>(csvPath.string(), &header, options, {});
+    CHECK(limited == std::vector<std::tuple<int>>{{1}, {2}, {3}, {4}, {5}, {6}, {8}, {9}, {10}, {11}});
+    CHECK(csv::to_partitions<int>("missing.csv").empty());
+    std::filesystem::remove(csvPath);
+}
+
+TEST_CASE("Row limits count the rows kept by filters")
+{
+    const auto csvPath = std::filesystem::temp_directory_path() / "std_csv_limits.csv";
+    const auto outputPath = std::filesystem::temp_directory_path() / "std_csv_limits_out.csv";
+    std::vector<std::tuple<int, std::string>> rows;
+    for (int i = 0; i < 1000; ++i)
+    {
+        rows.emplace_back(i, i % 2 == 0 ? "even" : "odd");
+    }
+    REQUIRE(csv::write(csvPath.string(), rows, std::array<std::string, 2>{"id", "parity"}));
+
+    // The first ten even ids, 0 to 18, whichever way the file is read
+    csv::read_options options;
+    options.maxRows = 10;
+    options.where_equal(1, "even");
+    std::vector<std::string> header;
+    CHECK(csv::to_tuples<int, csv::ignore>(csvPath.string(), options).size() == 10);
+    CHECK(csv::to_tuples<int, csv::ignore>(csvPath.string(), &header, options, {}).size() == 10);
+
+    const auto summaries = csv::aggregate(csvPath.string(), {0}, options);
+    REQUIRE(summaries.size() == 1);
+    CHECK(summaries[0].count == 10);
+    CHECK(summaries[0].max == 18);
+
+    const auto grouped = csv::group_by(csvPath.string(), 1, {0}, options);
+    REQUIRE(grouped.size() == 1);
+    CHECK(grouped.summary(0, 0).count == 10);
+
+    REQUIRE(csv::sort_file(csvPath.string(), outputPath.string(), 0, csv::column_type::integer, options));
+    CHECK(csv::to_tuples<int, csv::ignore>(outputPath.string(), &header, {}, {}).size() == 10);
+
+    size_t nJoined = 0;
+    REQUIRE(csv::join(csvPath.string(), 0, csvPath.string(), 0, [&nJoined](auto, auto) { ++nJoined; }, options));
+    CHECK(nJoined == 10);
+
+    std::filesystem::remove(csvPath);
+    std::filesystem::remove(outputPath);
+}